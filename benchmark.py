@@ -4,6 +4,7 @@ import psutil
 import matplotlib.pyplot as plt
 import numpy as np
 import os
+import json
 
 output_dir = "/Users/saicharan/Desktop/final/github"
 benchmark_file = os.path.join(output_dir, "benchmark_results.txt")
@@ -14,11 +15,22 @@ def get_system_info():
     cpu_freq = psutil.cpu_freq().max if psutil.cpu_freq() else 0
     return cpu_count, thread_count, cpu_freq
 
+stat_names = ["tasks", "steals", "idle_rate", "average_overhead_ns"]
+
+def parse_records(output, tag):
+    prefix = tag + ": "
+    return [json.loads(line[len(prefix):]) for line in output.decode(errors="replace").splitlines() if line.startswith(prefix)]
+
+def parse_runtime_stats(output):
+    records = parse_records(output, "stats")
+    return records[0] if records else {}
+
 def measure_performance_with_problem_size(executable_path, problem_sizes, runs=3):
     avg_times = []
     avg_cpu_usages = []
     max_thread_counts = []
     avg_memory_usages = []
+    avg_stats = {name: [] for name in stat_names}
     
     system_threads = psutil.cpu_count(logical=True)
     
@@ -27,10 +39,11 @@ def measure_performance_with_problem_size(executable_path, problem_sizes, runs=3
         cpu_usages = []
         all_threads = []
         memory_usages = []
+        run_stats = {name: [] for name in stat_names}
         
         for _ in range(runs):
             start_time = time.time()
-            process = subprocess.Popen([executable_path, str(problem_size)], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+            process = subprocess.Popen([executable_path, str(problem_size), "--stats"], stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
             
             temp_cpu = []
             temp_threads = []
@@ -58,10 +71,15 @@ def measure_performance_with_problem_size(executable_path, problem_sizes, runs=3
                     break
                 time.sleep(0.1)
             
-            process.wait()
+            output, _ = process.communicate()
             end_time = time.time()
             times.append(end_time - start_time)
             
+            stats = parse_runtime_stats(output)
+            for name in stat_names:
+                value = stats.get(name)
+                run_stats[name].append(np.nan if value is None else value)
+            
             avg_cpu = np.mean(temp_cpu) if temp_cpu else 0
             avg_memory = np.mean(temp_memory) if temp_memory else 0
             
@@ -74,10 +92,21 @@ def measure_performance_with_problem_size(executable_path, problem_sizes, runs=3
         max_threads = np.max(all_threads) if all_threads else 0
         max_thread_counts.append(max_threads)
         avg_memory_usages.append(np.mean(memory_usages))
+        for name in stat_names:
+            values = [v for v in run_stats[name] if not np.isnan(v)]
+            avg_stats[name].append(np.mean(values) if values else np.nan)
 
         
     
-    return avg_times, avg_cpu_usages, max_thread_counts, avg_memory_usages
+    return avg_times, avg_cpu_usages, max_thread_counts, avg_memory_usages, avg_stats
+
+# Runs every size inside one process, flushing caches between repetitions, so the
+# times are steady-state kernel times without process and runtime start-up.
+def measure_in_process_sweep(executable_path, problem_sizes, runs=3):
+    sizes = ",".join(str(size) for size in problem_sizes)
+    result = subprocess.run([executable_path, sizes, f"--reps={runs}", "--flush"], stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    mean_times = {int(record["size"]): record["mean_s"] for record in parse_records(result.stdout, "result")}
+    return [mean_times.get(size, np.nan) for size in problem_sizes]
 
 cpu_cores, cpu_threads, cpu_freq = get_system_info()
 
@@ -87,8 +116,10 @@ problem_sizes = [10, 100, 250,500,750,1000]
 hpx = "/Users/saicharan/Desktop/final/github/hpx/build/my_hpx_program"
 scheduler = "/Users/saicharan/Desktop/final/github/system_scheduler/build/scheduler"
 
-hpx_times, hpx_cpu, hpx_threads, hpx_memory = measure_performance_with_problem_size(hpx, problem_sizes)
-scheduler_times, scheduler_cpu, scheduler_threads, scheduler_memory = measure_performance_with_problem_size(scheduler, problem_sizes)
+hpx_times, hpx_cpu, hpx_threads, hpx_memory, hpx_stats = measure_performance_with_problem_size(hpx, problem_sizes)
+scheduler_times, scheduler_cpu, scheduler_threads, scheduler_memory, scheduler_stats = measure_performance_with_problem_size(scheduler, problem_sizes)
+hpx_sweep_times = measure_in_process_sweep(hpx, problem_sizes)
+scheduler_sweep_times = measure_in_process_sweep(scheduler, problem_sizes)
 
 avg_exec_time_hpx = np.mean(hpx_times)
 avg_exec_time_scheduler = np.mean(scheduler_times)
@@ -120,6 +151,8 @@ plt.suptitle(f"System Specs: {cpu_cores} Cores, {cpu_threads} Threads, {cpu_freq
 plt.subplot(2, 2, 1)
 plt.plot(problem_sizes, hpx_times, label='HPX', color='blue', marker='o', linestyle='-')
 plt.plot(problem_sizes, scheduler_times, label='Scheduler', color='orange', marker='s', linestyle='-')
+plt.plot(problem_sizes, hpx_sweep_times, label='HPX (in-process)', color='blue', marker='o', linestyle='--')
+plt.plot(problem_sizes, scheduler_sweep_times, label='Scheduler (in-process)', color='orange', marker='s', linestyle='--')
 plt.ylabel('Execution Time (s)')
 plt.xlabel('Problem Size')
 plt.title('Execution Time vs Problem Size')
@@ -160,4 +193,33 @@ plot_file = os.path.join(output_dir, "benchmark_scaling_plot.png")
 plt.savefig(plot_file)
 plt.show()
 
-print(f"\nScaling benchmark plot saved to: {plot_file}")
\ No newline at end of file
+print(f"\nScaling benchmark plot saved to: {plot_file}")
+
+# Each runtime's own scheduler counters (printed with --stats), side by side.
+stat_labels = {
+    "tasks": "Tasks Run",
+    "steals": "Tasks Stolen",
+    "idle_rate": "Idle Rate",
+    "average_overhead_ns": "Overhead per Task (ns)",
+}
+
+plt.figure(figsize=(18, 6))
+plt.suptitle("Runtime counters: HPX performance counters vs system_scheduler stats", fontsize=12)
+for i, name in enumerate(stat_names):
+    plt.subplot(2, 2, i + 1)
+    plt.plot(problem_sizes, hpx_stats[name], label='HPX', color='blue', marker='o', linestyle='-')
+    plt.plot(problem_sizes, scheduler_stats[name], label='Scheduler', color='orange', marker='s', linestyle='-')
+    plt.ylabel(stat_labels[name])
+    plt.xlabel('Problem Size')
+    plt.title(f'{stat_labels[name]} vs Problem Size')
+    plt.legend()
+    plt.grid(True)
+
+plt.tight_layout()
+plt.subplots_adjust(top=0.85)
+
+stats_plot_file = os.path.join(output_dir, "benchmark_runtime_stats.png")
+plt.savefig(stats_plot_file)
+plt.show()
+
+print(f"\nRuntime counter plot saved to: {stats_plot_file}")
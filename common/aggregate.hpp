@@ -0,0 +1,159 @@
+#ifndef AGGREGATE_HPP
+#define AGGREGATE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Histogram and group-by (count and sum per key) over a stream of (key, value)
+// records. Each kernel has two strategies: every worker fills a private table
+// and the tables are merged at the end, or all workers update one shared table
+// with atomics. Values are integers so every strategy gives exactly the same result.
+struct aggregate_input {
+    std::vector<std::uint32_t> keys;
+    std::vector<std::uint32_t> values;
+};
+
+// n records with keys in [0, groups) drawn from a Zipf distribution of exponent
+// skew (0 is uniform). Ranks are shuffled onto keys so hot keys are scattered.
+inline aggregate_input zipf_records(std::size_t n, std::size_t groups, double skew, std::uint64_t seed) {
+    std::vector<double> cdf(groups);
+    double total = 0;
+    for (std::size_t r = 0; r < groups; ++r) cdf[r] = total += std::pow(static_cast<double>(r + 1), -skew);
+    std::vector<std::uint32_t> key_of_rank(groups);
+    std::iota(key_of_rank.begin(), key_of_rank.end(), 0);
+    std::mt19937_64 rng(seed);
+    std::shuffle(key_of_rank.begin(), key_of_rank.end(), rng);
+
+    aggregate_input in{std::vector<std::uint32_t>(n), std::vector<std::uint32_t>(n)};
+    std::uniform_real_distribution<double> uniform(0, total);
+    std::uniform_int_distribution<std::uint32_t> value(0, 1000);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t r = std::min<std::size_t>(std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin(), groups - 1);
+        in.keys[i] = key_of_rank[r];
+        in.values[i] = value(rng);
+    }
+    return in;
+}
+
+// Private tables multiply memory by the worker count and add a merge pass, which
+// pays off while each worker's copy stays cache-resident. Bigger tables spread
+// updates over enough lines that a shared table sees little contention.
+constexpr std::size_t private_table_budget = 256 * 1024;
+
+inline bool prefer_private(std::size_t table_bytes) {
+    return table_bytes <= private_table_budget;
+}
+
+inline void histogram_add(std::vector<std::uint64_t>& counts, const aggregate_input& in, std::size_t begin, std::size_t end) {
+    const std::size_t buckets = counts.size();
+    for (std::size_t i = begin; i < end; ++i) ++counts[in.keys[i] % buckets];
+}
+
+inline void histogram_add(std::vector<std::atomic<std::uint64_t>>& counts, const aggregate_input& in, std::size_t begin, std::size_t end) {
+    const std::size_t buckets = counts.size();
+    for (std::size_t i = begin; i < end; ++i) counts[in.keys[i] % buckets].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline std::size_t group_hash(std::uint32_t key) noexcept {
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+inline std::size_t group_capacity(std::size_t groups) {
+    std::size_t capacity = 16;
+    while (capacity < 2 * groups) capacity *= 2;
+    return capacity;
+}
+
+constexpr std::uint32_t empty_key = std::numeric_limits<std::uint32_t>::max();
+
+// Open-addressing (linear probing) table of key -> (count, sum) for one thread.
+// Sized for a known number of distinct keys; it does not grow.
+struct group_table {
+    explicit group_table(std::size_t groups = 0)
+        : mask(group_capacity(groups) - 1), keys(mask + 1, empty_key), counts(mask + 1), sums(mask + 1) {}
+
+    void add(std::uint32_t key, std::uint64_t count, std::uint64_t sum) {
+        std::size_t slot = group_hash(key) & mask;
+        while (keys[slot] != key && keys[slot] != empty_key) slot = (slot + 1) & mask;
+        keys[slot] = key;
+        counts[slot] += count;
+        sums[slot] += sum;
+    }
+
+    void add(const aggregate_input& in, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) add(in.keys[i], 1, in.values[i]);
+    }
+
+    void merge(const group_table& other) {
+        other.for_each([this](std::uint32_t key, std::uint64_t count, std::uint64_t sum) { add(key, count, sum); });
+    }
+
+    template <class F>
+    void for_each(F&& f) const {
+        for (std::size_t s = 0; s <= mask; ++s) {
+            if (keys[s] != empty_key) f(keys[s], counts[s], sums[s]);
+        }
+    }
+
+    std::size_t bytes() const noexcept { return (mask + 1) * (sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t)); }
+
+    std::size_t mask;
+    std::vector<std::uint32_t> keys;
+    std::vector<std::uint64_t> counts, sums;
+};
+
+// The same table shared by all threads: a key claims its slot with a CAS and
+// the count and sum are atomic adds.
+struct shared_group_table {
+    explicit shared_group_table(std::size_t groups)
+        : mask(group_capacity(groups) - 1), keys(mask + 1), counts(mask + 1), sums(mask + 1) {
+        for (auto& k : keys) k.store(empty_key, std::memory_order_relaxed);
+    }
+
+    void add(const aggregate_input& in, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::uint32_t key = in.keys[i];
+            std::size_t slot = group_hash(key) & mask;
+            for (;;) {
+                std::uint32_t seen = keys[slot].load(std::memory_order_relaxed);
+                if (seen == empty_key && keys[slot].compare_exchange_strong(seen, key, std::memory_order_relaxed)) break;
+                if (seen == key) break;
+                slot = (slot + 1) & mask;
+            }
+            counts[slot].fetch_add(1, std::memory_order_relaxed);
+            sums[slot].fetch_add(in.values[i], std::memory_order_relaxed);
+        }
+    }
+
+    template <class F>
+    void for_each(F&& f) const {
+        for (std::size_t s = 0; s <= mask; ++s) {
+            const std::uint32_t key = keys[s].load(std::memory_order_relaxed);
+            if (key != empty_key) f(key, counts[s].load(std::memory_order_relaxed), sums[s].load(std::memory_order_relaxed));
+        }
+    }
+
+    std::size_t mask;
+    std::vector<std::atomic<std::uint32_t>> keys;
+    std::vector<std::atomic<std::uint64_t>> counts, sums;
+};
+
+// Per-key (count, sum) of a table as dense arrays over [0, groups), for comparing strategies.
+template <class Table>
+std::vector<std::uint64_t> group_totals(const Table& table, std::size_t groups) {
+    std::vector<std::uint64_t> totals(2 * groups);
+    table.for_each([&totals](std::uint32_t key, std::uint64_t count, std::uint64_t sum) {
+        totals[2 * key] += count;
+        totals[2 * key + 1] += sum;
+    });
+    return totals;
+}
+
+#endif // AGGREGATE_HPP
@@ -0,0 +1,30 @@
+#ifndef BLOCK_GRID_HPP
+#define BLOCK_GRID_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+// An m x n output split into block_rows x block_cols blocks numbered in row-major
+// order, so a flat loop over [0, size()) can hand out rows (1 x n blocks) or tiles.
+struct block_grid {
+    struct block {
+        std::size_t r0, r1, c0, c1;
+    };
+
+    std::size_t m;
+    std::size_t n;
+    std::size_t block_rows;
+    std::size_t block_cols;
+
+    std::size_t blocks_down() const noexcept { return (m + block_rows - 1) / block_rows; }
+    std::size_t blocks_across() const noexcept { return (n + block_cols - 1) / block_cols; }
+    std::size_t size() const noexcept { return blocks_down() * blocks_across(); }
+
+    block operator[](std::size_t b) const noexcept {
+        const std::size_t r0 = b / blocks_across() * block_rows;
+        const std::size_t c0 = b % blocks_across() * block_cols;
+        return {r0, std::min(m, r0 + block_rows), c0, std::min(n, c0 + block_cols)};
+    }
+};
+
+#endif // BLOCK_GRID_HPP
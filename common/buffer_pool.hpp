@@ -0,0 +1,38 @@
+#ifndef BUFFER_POOL_HPP
+#define BUFFER_POOL_HPP
+
+#include "matrix.hpp"
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Thread-safe free list of aligned buffers keyed by element count, so recursive
+// algorithms reuse temporaries of the same shape instead of hitting the allocator.
+template <class T>
+class buffer_pool {
+public:
+    aligned_buffer<T> acquire(std::size_t n) {
+        {
+            std::scoped_lock lock(mutex);
+            auto it = free_buffers.find(n);
+            if (it != free_buffers.end() && !it->second.empty()) {
+                aligned_buffer<T> buffer = std::move(it->second.back());
+                it->second.pop_back();
+                return buffer;
+            }
+        }
+        return aligned_buffer<T>(n);
+    }
+
+    void release(aligned_buffer<T> buffer) {
+        std::scoped_lock lock(mutex);
+        free_buffers[buffer.size()].push_back(std::move(buffer));
+    }
+
+private:
+    std::mutex mutex;
+    std::map<std::size_t, std::vector<aligned_buffer<T>>> free_buffers;
+};
+
+#endif // BUFFER_POOL_HPP
@@ -0,0 +1,38 @@
+#ifndef CACHE_FLUSH_HPP
+#define CACHE_FLUSH_HPP
+
+#include "matrix.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Evicts benchmark data between repetitions by rewriting a buffer larger than the
+// last-level cache. The buffer is walked in blocks inside parallel_for's body (see
+// gemm_packed for the contract), so the workers' private caches are flushed too,
+// not only the shared last level.
+constexpr std::size_t cache_flush_default_mib = 64;
+
+class cache_flusher {
+public:
+    explicit cache_flusher(std::size_t bytes) : buffer(std::max<std::size_t>(1, bytes / sizeof(std::uint64_t))) {
+        std::fill_n(buffer.data(), buffer.size(), 0);
+    }
+
+    template <class ParallelFor>
+    void flush(ParallelFor&& parallel_for) {
+        constexpr std::size_t block = (1 << 20) / sizeof(std::uint64_t);
+        const std::size_t n = buffer.size();
+        const std::uint64_t value = ++pass;
+        parallel_for((n + block - 1) / block, [&](std::size_t b) {
+            std::uint64_t* data = buffer.data();
+            const std::size_t last = std::min(n, (b + 1) * block);
+            for (std::size_t i = b * block; i < last; ++i) data[i] += value;
+        });
+    }
+
+private:
+    aligned_buffer<std::uint64_t> buffer;
+    std::uint64_t pass = 0;
+};
+
+#endif // CACHE_FLUSH_HPP
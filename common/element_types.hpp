@@ -0,0 +1,86 @@
+#ifndef ELEMENT_TYPES_HPP
+#define ELEMENT_TYPES_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Storage element types the benchmarks are instantiated for, with the type
+// products are accumulated in and the type the result matrix is stored as.
+// int32 keeps the original workload (int storage, double accumulator); the
+// narrow integer types accumulate in int32 as quantised kernels do.
+template <class T>
+struct element_traits;
+
+template <>
+struct element_traits<std::int32_t> {
+    using accumulator = double;
+    using result = std::int32_t;
+    static constexpr const char* name = "int32";
+};
+
+template <>
+struct element_traits<std::int16_t> {
+    using accumulator = std::int32_t;
+    using result = std::int32_t;
+    static constexpr const char* name = "int16";
+};
+
+template <>
+struct element_traits<std::int8_t> {
+    using accumulator = std::int32_t;
+    using result = std::int32_t;
+    static constexpr const char* name = "int8";
+};
+
+template <>
+struct element_traits<float> {
+    using accumulator = float;
+    using result = float;
+    static constexpr const char* name = "float";
+};
+
+template <>
+struct element_traits<double> {
+    using accumulator = double;
+    using result = double;
+    static constexpr const char* name = "double";
+};
+
+template <class T>
+using accumulator_t = typename element_traits<T>::accumulator;
+
+template <class T>
+using result_t = typename element_traits<T>::result;
+
+// Per-element weight the workload applies to A: C[i][j] = sum_k A[i][k] * sin(A[i][k]) * B[k][j].
+// Integer accumulators cannot hold the fractional weight, so they compute the plain product.
+template <class T>
+accumulator_t<T> weighted(T a) {
+    using Acc = accumulator_t<T>;
+    if constexpr (std::is_floating_point_v<Acc>) {
+        return static_cast<Acc>(a) * std::sin(static_cast<Acc>(a));
+    } else {
+        return static_cast<Acc>(a);
+    }
+}
+
+template <class T>
+struct element_tag {
+    using type = T;
+};
+
+// Calls f(element_tag<T>{}) for the element type named by `name`; returns false if unknown.
+template <class F>
+bool dispatch_element_type(const std::string& name, F&& f) {
+    if (name == "int32") f(element_tag<std::int32_t>{});
+    else if (name == "int16") f(element_tag<std::int16_t>{});
+    else if (name == "int8") f(element_tag<std::int8_t>{});
+    else if (name == "float") f(element_tag<float>{});
+    else if (name == "double") f(element_tag<double>{});
+    else return false;
+    return true;
+}
+
+#endif // ELEMENT_TYPES_HPP
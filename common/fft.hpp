@@ -0,0 +1,160 @@
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include "matrix.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Forward complex FFT of power-of-two length by recursive decimation in time:
+// the input, read with a stride, splits into 4 (or, for a leftover factor of 2,
+// 2) interleaved sub-sequences whose transforms land in consecutive quarters
+// (halves) of the output, and a butterfly pass over those combines them in place.
+// Sub-transforms are independent and every butterfly index k is independent, so
+// both levels parallelise: fork-join over the sub-transforms, bulk over k.
+using cplx = std::complex<double>;
+
+constexpr double fft_pi = 3.141592653589793;
+
+inline bool is_power_of_two(std::size_t n) noexcept {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+// w[k] = exp(-2 pi i k / n) for k < n; a length-m transform uses every (n / m)-th entry.
+inline std::vector<cplx> fft_twiddles(std::size_t n) {
+    std::vector<cplx> w(n);
+    for (std::size_t k = 0; k < n; ++k) w[k] = std::polar(1.0, -2 * fft_pi * static_cast<double>(k) / static_cast<double>(n));
+    return w;
+}
+
+inline std::size_t fft_radix(std::size_t n) noexcept {
+    return n % 4 == 0 ? 4 : 2;
+}
+
+// Butterflies k in [k0, k1) of a length-n transform whose radix sub-transforms are
+// in out[0, n). w is the twiddle table for a transform of length n * w_step.
+inline void fft_combine(cplx* out, std::size_t n, const cplx* w, std::size_t w_step, std::size_t k0, std::size_t k1) {
+    if (fft_radix(n) == 2) {
+        const std::size_t m = n / 2;
+        for (std::size_t k = k0; k < k1; ++k) {
+            const cplx a = out[k], b = w[k * w_step] * out[m + k];
+            out[k] = a + b;
+            out[m + k] = a - b;
+        }
+        return;
+    }
+    const std::size_t m = n / 4;
+    for (std::size_t k = k0; k < k1; ++k) {
+        const cplx a = out[k];
+        const cplx b = w[k * w_step] * out[m + k];
+        const cplx c = w[2 * k * w_step] * out[2 * m + k];
+        const cplx d = w[3 * k * w_step] * out[3 * m + k];
+        const cplx a_plus_c = a + c, a_minus_c = a - c, b_plus_d = b + d;
+        const cplx b_minus_d_times_i{-(b - d).imag(), (b - d).real()};
+        out[k] = a_plus_c + b_plus_d;
+        out[m + k] = a_minus_c - b_minus_d_times_i;
+        out[2 * m + k] = a_plus_c - b_plus_d;
+        out[3 * m + k] = a_minus_c + b_minus_d_times_i;
+    }
+}
+
+// out[0, n) = FFT of in[0], in[stride], ..., in[(n - 1) * stride]; in and out must not overlap.
+inline void fft_serial(const cplx* in, std::size_t stride, cplx* out, std::size_t n, const cplx* w, std::size_t w_step) {
+    if (n == 1) {
+        out[0] = in[0];
+        return;
+    }
+    const std::size_t r = fft_radix(n), m = n / r;
+    for (std::size_t q = 0; q < r; ++q) fft_serial(in + q * stride, stride * r, out + q * m, m, w, w_step * r);
+    fft_combine(out, n, w, w_step, 0, m);
+}
+
+// O(n^2) DFT for validation.
+inline std::vector<cplx> naive_dft(const cplx* in, std::size_t stride, std::size_t n) {
+    std::vector<cplx> out(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        cplx sum = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            sum += in[j * stride] * std::polar(1.0, -2 * fft_pi * static_cast<double>((j * k) % n) / static_cast<double>(n));
+        }
+        out[k] = sum;
+    }
+    return out;
+}
+
+// 2D naive DFT: naive_dft over every row, then over every column of the result.
+inline dense_matrix<cplx> naive_dft_2d(matrix_view<const cplx> in) {
+    dense_matrix<cplx> rows(in.rows, in.cols), out(in.rows, in.cols);
+    for (std::size_t i = 0; i < in.rows; ++i) {
+        const auto row = naive_dft(in.row(i), 1, in.cols);
+        std::copy(row.begin(), row.end(), &rows(i, 0));
+    }
+    for (std::size_t j = 0; j < in.cols; ++j) {
+        const auto col = naive_dft(&rows(0, j), rows.stride(), in.rows);
+        for (std::size_t i = 0; i < in.rows; ++i) out(i, j) = col[i];
+    }
+    return out;
+}
+
+// dst = src^T for the rows [r0, r1) of src, in tile x tile blocks so both sides
+// are walked a few cache lines at a time.
+inline void transpose_rows(matrix_view<const cplx> src, matrix_view<cplx> dst, std::size_t r0, std::size_t r1, std::size_t tile = 32) {
+    for (std::size_t ii = r0; ii < r1; ii += tile) {
+        for (std::size_t jj = 0; jj < src.cols; jj += tile) {
+            for (std::size_t i = ii; i < std::min(r1, ii + tile); ++i) {
+                for (std::size_t j = jj; j < std::min(src.cols, jj + tile); ++j) dst(j, i) = src(i, j);
+            }
+        }
+    }
+}
+
+// 2D FFT of a rows x cols matrix by row transforms, a transpose, row transforms
+// of the transposed matrix and a transpose back. for_blocks(count, f) runs f(b)
+// for b in [0, count) in parallel and waits; each block is `block` rows.
+struct fft_2d_plan {
+    fft_2d_plan(std::size_t rows, std::size_t cols)
+        : w_rows(fft_twiddles(cols)), w_cols(fft_twiddles(rows)), a(rows, cols, uninitialized), b(cols, rows, uninitialized),
+          c(cols, rows, uninitialized) {}
+
+    template <class ForBlocks>
+    void run(ForBlocks&& for_blocks, matrix_view<const cplx> in, matrix_view<cplx> out, std::size_t block = 32) {
+        const std::size_t rows = in.rows, cols = in.cols;
+        auto each_row = [&](std::size_t count, auto&& f) {
+            for_blocks((count + block - 1) / block, [&](std::size_t k) {
+                for (std::size_t i = k * block; i < std::min(count, (k + 1) * block); ++i) f(i);
+            });
+        };
+        each_row(rows, [&](std::size_t i) { fft_serial(in.row(i), 1, &a(i, 0), cols, w_rows.data(), 1); });
+        for_blocks((rows + block - 1) / block, [&](std::size_t k) {
+            transpose_rows(std::as_const(a).view(), b.view(), k * block, std::min(rows, (k + 1) * block));
+        });
+        each_row(cols, [&](std::size_t j) { fft_serial(&b(j, 0), 1, &c(j, 0), rows, w_cols.data(), 1); });
+        for_blocks((cols + block - 1) / block, [&](std::size_t k) {
+            transpose_rows(std::as_const(c).view(), out, k * block, std::min(cols, (k + 1) * block));
+        });
+    }
+
+    std::vector<cplx> w_rows, w_cols;
+    dense_matrix<cplx> a, b, c;
+};
+
+inline std::vector<cplx> random_signal(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    std::vector<cplx> x(n);
+    for (auto& v : x) v = {uniform(rng), uniform(rng)};
+    return x;
+}
+
+template <class A, class B>
+double max_abs_error(const A& a, const B& b, std::size_t n) {
+    double error = 0;
+    for (std::size_t i = 0; i < n; ++i) error = std::max(error, std::abs(a[i] - b[i]));
+    return error;
+}
+
+#endif // FFT_HPP
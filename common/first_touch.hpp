@@ -0,0 +1,30 @@
+#ifndef FIRST_TOUCH_HPP
+#define FIRST_TOUCH_HPP
+
+#include "matrix.hpp"
+#include <algorithm>
+#include <cstddef>
+
+// Linux places a page on the NUMA node of the thread that first writes it. Filling
+// a matrix in parallel, in the row blocks the kernels later compute on, spreads its
+// pages over the nodes of the workers instead of putting them all on the main
+// thread's node. This is best effort: neither runtime maps a block to the same
+// worker for initialisation and compute, so a block's pages need not be local to
+// the worker that later uses them.
+
+// The packed kernel's row-block height and the recursive kernel's leaf size.
+constexpr std::size_t first_touch_rows = 64;
+
+// Writes value to every element of M, one first_touch_rows block per call of
+// parallel_for's body (see gemm_packed for the parallel_for contract).
+template <class T, class ParallelFor>
+void first_touch_fill(matrix_view<T> M, T value, ParallelFor&& parallel_for) {
+    parallel_for((M.rows + first_touch_rows - 1) / first_touch_rows, [&](std::size_t b) {
+        const std::size_t last = std::min(M.rows, (b + 1) * first_touch_rows);
+        for (std::size_t i = b * first_touch_rows; i < last; ++i) {
+            std::fill_n(M.row(i), M.cols, value);
+        }
+    });
+}
+
+#endif // FIRST_TOUCH_HPP
@@ -0,0 +1,82 @@
+#ifndef GEMM_BATCHED_HPP
+#define GEMM_BATCHED_HPP
+
+#include "matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+// A batch of `count` independent n x n products C[b] = A[b] * B[b], each matrix
+// stored densely (stride n) one after another.
+template <class T, class Acc>
+struct gemm_batch {
+    gemm_batch(std::size_t count, std::size_t n) : count(count), n(n), a(count * n * n), b(count * n * n), c(count * n * n) {}
+
+    const T* a_matrix(std::size_t i) const noexcept { return a.data() + i * n * n; }
+    const T* b_matrix(std::size_t i) const noexcept { return b.data() + i * n * n; }
+    Acc* c_matrix(std::size_t i) const noexcept { return c.data() + i * n * n; }
+
+    std::size_t count;
+    std::size_t n;
+    aligned_buffer<T> a;
+    aligned_buffer<T> b;
+    aligned_buffer<Acc> c;
+};
+
+template <class T, class Acc>
+void fill_batch(gemm_batch<T, Acc>& batch, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    const std::size_t elements = batch.count * batch.n * batch.n;
+    auto next = [&rng]() {
+        if constexpr (std::is_floating_point_v<T>) {
+            return std::uniform_real_distribution<T>(-1, 1)(rng);
+        } else {
+            return static_cast<T>(std::uniform_int_distribution<int>(-3, 3)(rng));
+        }
+    };
+    for (std::size_t i = 0; i < elements; ++i) {
+        batch.a.data()[i] = next();
+        batch.b.data()[i] = next();
+    }
+}
+
+// C = A * B for one n x n matrix in i-k-j order. With N != 0 the size is a
+// compile-time constant, so the compiler can fully unroll and vectorise the j loop.
+template <std::size_t N, class T, class Acc>
+void small_gemm(const T* a, const T* b, Acc* c, std::size_t n) {
+    if constexpr (N != 0) n = N;
+    for (std::size_t i = 0; i < n; ++i) {
+        Acc* c_row = c + i * n;
+        for (std::size_t j = 0; j < n; ++j) c_row[j] = Acc{};
+        for (std::size_t k = 0; k < n; ++k) {
+            const Acc a_ik = static_cast<Acc>(a[i * n + k]);
+            const T* b_row = b + k * n;
+            for (std::size_t j = 0; j < n; ++j) c_row[j] += a_ik * static_cast<Acc>(b_row[j]);
+        }
+    }
+}
+
+// Multiplies matrices [first, last) of the batch.
+template <std::size_t N, class T, class Acc>
+void multiply_batch_range(const gemm_batch<T, Acc>& batch, std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+        small_gemm<N>(batch.a_matrix(i), batch.b_matrix(i), batch.c_matrix(i), batch.n);
+    }
+}
+
+// Calls f(std::integral_constant<std::size_t, N>{}) with N = n for the common
+// power-of-two sizes 4..64 and N = 0 (runtime size) otherwise.
+template <class F>
+void dispatch_small_size(std::size_t n, F&& f) {
+    switch (n) {
+    case 4: f(std::integral_constant<std::size_t, 4>{}); break;
+    case 8: f(std::integral_constant<std::size_t, 8>{}); break;
+    case 16: f(std::integral_constant<std::size_t, 16>{}); break;
+    case 32: f(std::integral_constant<std::size_t, 32>{}); break;
+    case 64: f(std::integral_constant<std::size_t, 64>{}); break;
+    default: f(std::integral_constant<std::size_t, 0>{}); break;
+    }
+}
+
+#endif // GEMM_BATCHED_HPP
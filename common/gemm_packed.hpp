@@ -0,0 +1,177 @@
+#ifndef GEMM_PACKED_HPP
+#define GEMM_PACKED_HPP
+
+#include "matrix.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// GotoBLAS-style blocking, selected at compile time by the packed element type.
+// An mc x kc block of A lives in L2, a kc x nc panel of B in L3, and the
+// mr x nr micro-tile of C in registers. The primary template targets 8-byte
+// elements; narrower types get deeper panels for the same cache footprint. A 4 x 8
+// tile measured best for every type when compiled for baseline x86-64 (SSE2).
+template <class Packed>
+struct gemm_blocking {
+    static constexpr std::size_t mr = 4;
+    static constexpr std::size_t nr = 8;
+    static constexpr std::size_t mc = 64;
+    static constexpr std::size_t kc = 256;
+    static constexpr std::size_t nc = 2048;
+    static constexpr std::size_t slivers_per_pack_task = 8;
+};
+
+template <>
+struct gemm_blocking<float> {
+    static constexpr std::size_t mr = 4;
+    static constexpr std::size_t nr = 8;
+    static constexpr std::size_t mc = 64;
+    static constexpr std::size_t kc = 512;
+    static constexpr std::size_t nc = 2048;
+    static constexpr std::size_t slivers_per_pack_task = 8;
+};
+
+template <>
+struct gemm_blocking<std::int32_t> : gemm_blocking<float> {};
+
+// Narrow integers stay narrow in the packed panels (halving or quartering their
+// traffic) and are widened to the accumulator inside the micro-kernel.
+template <>
+struct gemm_blocking<std::int16_t> {
+    static constexpr std::size_t mr = 4;
+    static constexpr std::size_t nr = 8;
+    static constexpr std::size_t mc = 64;
+    static constexpr std::size_t kc = 1024;
+    static constexpr std::size_t nc = 2048;
+    static constexpr std::size_t slivers_per_pack_task = 8;
+};
+
+template <>
+struct gemm_blocking<std::int8_t> : gemm_blocking<std::int16_t> {};
+
+// Panels are packed in the storage type when it is a narrower integer than the
+// accumulator, and in the accumulator type otherwise (e.g. int storage, double sums).
+template <class T, class Acc>
+using packed_t = std::conditional_t<std::is_integral_v<T> && std::is_integral_v<Acc> && (sizeof(T) < sizeof(Acc)), T, Acc>;
+
+// Scratch memory owned by the calling worker thread and reused by every task it
+// runs. Each slot is an independent buffer, so one thread can hold several at once.
+enum scratch_slot { a_block_slot, b_panel_slot };
+
+template <class T, int slot = a_block_slot>
+T* worker_scratch(std::size_t n) {
+    thread_local aligned_buffer<T> buffer;
+    buffer.reserve(n);
+    return buffer.data();
+}
+
+// Packs A into mr-row slivers, each stored k-major so the micro-kernel reads
+// mr consecutive values per k. Rows past the edge are zero-filled.
+template <class Packed, class T, class Op>
+void pack_a(matrix_view<T> A, Packed* dst, Op op) {
+    constexpr std::size_t mr = gemm_blocking<Packed>::mr;
+    for (std::size_t i0 = 0; i0 < A.rows; i0 += mr) {
+        std::size_t m = std::min(mr, A.rows - i0);
+        for (std::size_t k = 0; k < A.cols; ++k) {
+            for (std::size_t i = 0; i < mr; ++i) {
+                *dst++ = i < m ? static_cast<Packed>(op(A(i0 + i, k))) : Packed{};
+            }
+        }
+    }
+}
+
+// Packs nr-column slivers [first, last) of B; each sliver is stored k-major
+// with nr consecutive values per k. Columns past the edge are zero-filled.
+template <class Packed, class T>
+void pack_b(matrix_view<T> B, Packed* dst, std::size_t first, std::size_t last) {
+    constexpr std::size_t nr = gemm_blocking<Packed>::nr;
+    for (std::size_t s = first; s < last; ++s) {
+        std::size_t j0 = s * nr;
+        std::size_t n = std::min(nr, B.cols - j0);
+        Packed* out = dst + s * B.rows * nr;
+        for (std::size_t k = 0; k < B.rows; ++k) {
+            const T* src = B.row(k) + j0;
+            for (std::size_t j = 0; j < nr; ++j) {
+                *out++ = j < n ? static_cast<Packed>(src[j]) : Packed{};
+            }
+        }
+    }
+}
+
+// C (at most mr x nr) += packed A sliver * packed B sliver. The register tile
+// shape comes from gemm_blocking<Packed>; operands are widened to Acc per multiply.
+template <class Packed, class Acc>
+void micro_kernel(std::size_t kc, const Packed* a, const Packed* b, matrix_view<Acc> C) {
+    constexpr std::size_t mr = gemm_blocking<Packed>::mr;
+    constexpr std::size_t nr = gemm_blocking<Packed>::nr;
+    Acc c[mr][nr] = {};
+    for (std::size_t k = 0; k < kc; ++k) {
+        for (std::size_t i = 0; i < mr; ++i) {
+            const Acc a_ik = static_cast<Acc>(a[k * mr + i]);
+            for (std::size_t j = 0; j < nr; ++j) {
+                c[i][j] += a_ik * static_cast<Acc>(b[k * nr + j]);
+            }
+        }
+    }
+    for (std::size_t i = 0; i < C.rows; ++i) {
+        for (std::size_t j = 0; j < C.cols; ++j) {
+            C(i, j) += c[i][j];
+        }
+    }
+}
+
+template <class Packed, class Acc>
+void macro_kernel(const Packed* a, const Packed* b, std::size_t kc, matrix_view<Acc> C) {
+    constexpr std::size_t mr = gemm_blocking<Packed>::mr;
+    constexpr std::size_t nr = gemm_blocking<Packed>::nr;
+    for (std::size_t jr = 0; jr < C.cols; jr += nr) {
+        for (std::size_t ir = 0; ir < C.rows; ir += mr) {
+            micro_kernel(kc, a + ir * kc, b + jr * kc,
+                         C.block(ir, jr, std::min(mr, C.rows - ir), std::min(nr, C.cols - jr)));
+        }
+    }
+}
+
+// C += op(A) * B, where op is applied to each element of A while it is packed.
+// parallel_for(n, f) must call f(0) .. f(n - 1), possibly concurrently, and
+// return only once all calls have finished. Each kc x nc panel of B is packed
+// cooperatively into one shared buffer; each mc-row block of A is packed by the
+// task that consumes it into that worker's scratch memory. The B buffer comes from
+// the calling thread's scratch, so repeated small calls do not allocate.
+template <class Acc, class TA, class TB, class Op, class ParallelFor>
+void gemm_packed(matrix_view<TA> A, matrix_view<TB> B, matrix_view<Acc> C, Op op, ParallelFor&& parallel_for) {
+    using Packed = packed_t<std::remove_const_t<TA>, Acc>;
+    using blk = gemm_blocking<Packed>;
+    const std::size_t m = A.rows;
+    const std::size_t depth = A.cols;
+    const std::size_t n = B.cols;
+
+    Packed* b_panel = worker_scratch<Packed, b_panel_slot>(blk::kc * ((std::min(blk::nc, n) + blk::nr - 1) / blk::nr * blk::nr));
+
+    for (std::size_t jc = 0; jc < n; jc += blk::nc) {
+        const std::size_t nc = std::min(blk::nc, n - jc);
+        const std::size_t slivers = (nc + blk::nr - 1) / blk::nr;
+        const std::size_t pack_tasks = (slivers + blk::slivers_per_pack_task - 1) / blk::slivers_per_pack_task;
+
+        for (std::size_t pc = 0; pc < depth; pc += blk::kc) {
+            const std::size_t kc = std::min(blk::kc, depth - pc);
+            const auto B_panel = B.block(pc, jc, kc, nc);
+
+            parallel_for(pack_tasks, [&](std::size_t t) {
+                std::size_t first = t * blk::slivers_per_pack_task;
+                pack_b<Packed>(B_panel, b_panel, first, std::min(slivers, first + blk::slivers_per_pack_task));
+            });
+
+            parallel_for((m + blk::mc - 1) / blk::mc, [&](std::size_t ib) {
+                const std::size_t ic = ib * blk::mc;
+                const std::size_t mc = std::min(blk::mc, m - ic);
+                Packed* a = worker_scratch<Packed, a_block_slot>(blk::mc * blk::kc);
+                pack_a<Packed>(A.block(ic, pc, mc, kc), a, op);
+                macro_kernel(a, b_panel, kc, C.block(ic, jc, mc, nc));
+            });
+        }
+    }
+}
+
+#endif // GEMM_PACKED_HPP
@@ -0,0 +1,97 @@
+#ifndef GEMM_PIPELINE_HPP
+#define GEMM_PIPELINE_HPP
+
+#include "matrix.hpp"
+#include "element_types.hpp"
+#include "first_touch.hpp"
+#include "gemm_recursive.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// The matrix workload as four dependent stages over first_touch_rows row blocks:
+//   init       A and B get a fixed pattern (two independent stages),
+//   transform  Aw = weighted(A), Bw = B widened to the accumulator type,
+//   multiply   C = Aw * Bw,
+//   checksum   partial[b] = sum of C's rows in block b.
+// Each stage function handles one block, so a runtime can run a stage as a bulk
+// operation and chain the stages however it expresses dependencies.
+template <class T>
+struct gemm_pipeline {
+    using Acc = accumulator_t<T>;
+
+    explicit gemm_pipeline(std::size_t n)
+        : n(n), blocks((n + first_touch_rows - 1) / first_touch_rows), A(n, n, uninitialized), B(n, n, uninitialized),
+          Aw(n, n, uninitialized), Bw(n, n, uninitialized), C(n, n, uninitialized), partial(blocks) {}
+
+    static T a_value(std::size_t i, std::size_t j) { return static_cast<T>(static_cast<int>((3 * i + j) % 7) - 2); }
+    static T b_value(std::size_t i, std::size_t j) { return static_cast<T>((i + 2 * j) % 5 + 1); }
+
+    std::size_t first_row(std::size_t b) const { return b * first_touch_rows; }
+    std::size_t last_row(std::size_t b) const { return std::min(n, (b + 1) * first_touch_rows); }
+
+    void init_a(std::size_t b) {
+        for (std::size_t i = first_row(b); i < last_row(b); ++i) {
+            for (std::size_t j = 0; j < n; ++j) A(i, j) = a_value(i, j);
+        }
+    }
+
+    void init_b(std::size_t b) {
+        for (std::size_t i = first_row(b); i < last_row(b); ++i) {
+            for (std::size_t j = 0; j < n; ++j) B(i, j) = b_value(i, j);
+        }
+    }
+
+    void transform(std::size_t b) {
+        for (std::size_t i = first_row(b); i < last_row(b); ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                Aw(i, j) = weighted(A(i, j));
+                Bw(i, j) = static_cast<Acc>(B(i, j));
+            }
+        }
+    }
+
+    void multiply(std::size_t b) {
+        const std::size_t r0 = first_row(b), rows = last_row(b) - r0;
+        auto c = C.view().block(r0, 0, rows, n);
+        for (std::size_t i = 0; i < rows; ++i) std::fill_n(c.row(i), n, Acc{});
+        gemm_base(Aw.view().block(r0, 0, rows, n), std::as_const(Bw).view(), c, [](Acc a) { return a; });
+    }
+
+    void checksum(std::size_t b) {
+        Acc sum{};
+        for (std::size_t i = first_row(b); i < last_row(b); ++i) {
+            for (std::size_t j = 0; j < n; ++j) sum += C(i, j);
+        }
+        partial[b] = sum;
+    }
+
+    Acc total() const {
+        Acc sum{};
+        for (Acc p : partial) sum += p;
+        return sum;
+    }
+
+    // sum_ij (Aw Bw)_ij = sum_k (column k of Aw summed) * (row k of B summed), in O(n^2).
+    static Acc expected_total(std::size_t n) {
+        Acc sum{};
+        for (std::size_t k = 0; k < n; ++k) {
+            Acc a_col{}, b_row{};
+            for (std::size_t i = 0; i < n; ++i) {
+                a_col += weighted(a_value(i, k));
+                b_row += static_cast<Acc>(b_value(k, i));
+            }
+            sum += a_col * b_row;
+        }
+        return sum;
+    }
+
+    std::size_t n;
+    std::size_t blocks;
+    dense_matrix<T> A, B;
+    dense_matrix<Acc> Aw, Bw, C;
+    std::vector<Acc> partial;
+};
+
+#endif // GEMM_PIPELINE_HPP
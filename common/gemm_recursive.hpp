@@ -0,0 +1,68 @@
+#ifndef GEMM_RECURSIVE_HPP
+#define GEMM_RECURSIVE_HPP
+
+#include "matrix.hpp"
+#include <cstddef>
+
+// Sub-multiplications stop splitting once every dimension is at most this size,
+// so the three base-case blocks fit comfortably in L1/L2.
+constexpr std::size_t recursive_base_size = 64;
+
+enum class split_dim { none, m, n, k };
+
+// Cache-oblivious splitting rule: halve the largest of m, n and k.
+inline split_dim choose_split(std::size_t m, std::size_t n, std::size_t k, std::size_t base = recursive_base_size) {
+    if (m <= base && n <= base && k <= base) return split_dim::none;
+    if (m >= n && m >= k) return split_dim::m;
+    if (n >= k) return split_dim::n;
+    return split_dim::k;
+}
+
+// One half of a product C += op(A) * B. m- and n-splits give two independent
+// halves; a k-split gives two halves that update the same C and must run in order.
+template <class TA, class TB, class Acc>
+struct gemm_halves {
+    matrix_view<TA> a[2];
+    matrix_view<TB> b[2];
+    matrix_view<Acc> c[2];
+};
+
+template <class TA, class TB, class Acc>
+gemm_halves<TA, TB, Acc> split_gemm(split_dim dim, matrix_view<TA> A, matrix_view<TB> B, matrix_view<Acc> C) {
+    const std::size_t m = A.rows, k = A.cols, n = B.cols;
+    switch (dim) {
+    case split_dim::m: {
+        const std::size_t h = m / 2;
+        return {{A.block(0, 0, h, k), A.block(h, 0, m - h, k)}, {B, B},
+                {C.block(0, 0, h, n), C.block(h, 0, m - h, n)}};
+    }
+    case split_dim::n: {
+        const std::size_t h = n / 2;
+        return {{A, A}, {B.block(0, 0, k, h), B.block(0, h, k, n - h)},
+                {C.block(0, 0, m, h), C.block(0, h, m, n - h)}};
+    }
+    case split_dim::k: {
+        const std::size_t h = k / 2;
+        return {{A.block(0, 0, m, h), A.block(0, h, m, k - h)}, {B.block(0, 0, h, n), B.block(h, 0, k - h, n)}, {C, C}};
+    }
+    default:
+        return {{A, A}, {B, B}, {C, C}};
+    }
+}
+
+// Base case, C += op(A) * B in i-k-j order so B and C are walked with unit stride.
+template <class TA, class TB, class Acc, class Op>
+void gemm_base(matrix_view<TA> A, matrix_view<TB> B, matrix_view<Acc> C, Op op) {
+    for (std::size_t i = 0; i < A.rows; ++i) {
+        Acc* c = C.row(i);
+        for (std::size_t k = 0; k < A.cols; ++k) {
+            const Acc a = static_cast<Acc>(op(A(i, k)));
+            const TB* b = B.row(k);
+            for (std::size_t j = 0; j < B.cols; ++j) {
+                c[j] += a * static_cast<Acc>(b[j]);
+            }
+        }
+    }
+}
+
+#endif // GEMM_RECURSIVE_HPP
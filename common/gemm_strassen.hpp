@@ -0,0 +1,160 @@
+#ifndef GEMM_STRASSEN_HPP
+#define GEMM_STRASSEN_HPP
+
+#include "buffer_pool.hpp"
+#include "matrix.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+// Strassen-Winograd building blocks for square power-of-two-multiple matrices.
+// The runtimes own the recursion: they compute the operands, run the seven
+// products (in parallel near the root) and combine the results.
+
+constexpr std::size_t strassen_default_cutoff = 128;
+
+// Recursion levels below which the seven products are run inline rather than as tasks.
+constexpr std::size_t strassen_parallel_depth = 2;
+
+// Smallest size >= n that halves evenly down to a leaf no larger than cutoff.
+inline std::size_t strassen_padded_size(std::size_t n, std::size_t cutoff) {
+    std::size_t leaf = n;
+    std::size_t levels = 0;
+    while (leaf > cutoff) {
+        leaf = (leaf + 1) / 2;
+        ++levels;
+    }
+    return leaf << levels;
+}
+
+// Size of the leaves a padded size recurses down to.
+inline std::size_t strassen_leaf_size(std::size_t padded, std::size_t cutoff) {
+    while (padded > cutoff) padded /= 2;
+    return padded;
+}
+
+// Temporaries for one recursion step: S1..S4, T1..T4 and P1..P7, each h x h,
+// borrowed from a pool and returned when the step finishes.
+template <class T>
+class strassen_workspace {
+public:
+    strassen_workspace(buffer_pool<T>& pool, std::size_t h) : pool(pool) {
+        for (std::size_t i = 0; i < buffers.size(); ++i) {
+            buffers[i] = pool.acquire(h * h);
+            views[i] = {buffers[i].data(), h, h, h};
+        }
+    }
+
+    strassen_workspace(const strassen_workspace&) = delete;
+    strassen_workspace& operator=(const strassen_workspace&) = delete;
+
+    ~strassen_workspace() { release(); }
+
+    // Returns the buffers to the pool. Call this before signalling completion:
+    // copies of the owning pointer may outlive the pool.
+    void release() {
+        if (released) return;
+        released = true;
+        for (auto& buffer : buffers) pool.release(std::move(buffer));
+    }
+
+    matrix_view<T> s(std::size_t i) const noexcept { return views[i]; }
+    matrix_view<T> t(std::size_t i) const noexcept { return views[4 + i]; }
+    matrix_view<T> p(std::size_t i) const noexcept { return views[8 + i]; }
+
+private:
+    buffer_pool<T>& pool;
+    std::array<aligned_buffer<T>, 15> buffers;
+    std::array<matrix_view<T>, 15> views;
+    bool released = false;
+};
+
+template <class T>
+struct strassen_product {
+    matrix_view<const T> a;
+    matrix_view<const T> b;
+};
+
+// Forms S1..S4 and T1..T4 in the workspace and returns the seven Winograd
+// products P1..P7 as (left, right) operand pairs.
+template <class T>
+std::array<strassen_product<T>, 7> winograd_operands(matrix_view<const T> A, matrix_view<const T> B, const strassen_workspace<T>& ws) {
+    const std::size_t h = A.rows / 2;
+    auto A11 = A.block(0, 0, h, h), A12 = A.block(0, h, h, h), A21 = A.block(h, 0, h, h), A22 = A.block(h, h, h, h);
+    auto B11 = B.block(0, 0, h, h), B12 = B.block(0, h, h, h), B21 = B.block(h, 0, h, h), B22 = B.block(h, h, h, h);
+    auto S1 = ws.s(0), S2 = ws.s(1), S3 = ws.s(2), S4 = ws.s(3);
+    auto T1 = ws.t(0), T2 = ws.t(1), T3 = ws.t(2), T4 = ws.t(3);
+
+    for (std::size_t i = 0; i < h; ++i) {
+        for (std::size_t j = 0; j < h; ++j) {
+            S1(i, j) = A21(i, j) + A22(i, j);
+            S2(i, j) = S1(i, j) - A11(i, j);
+            S3(i, j) = A11(i, j) - A21(i, j);
+            S4(i, j) = A12(i, j) - S2(i, j);
+            T1(i, j) = B12(i, j) - B11(i, j);
+            T2(i, j) = B22(i, j) - T1(i, j);
+            T3(i, j) = B22(i, j) - B12(i, j);
+            T4(i, j) = T2(i, j) - B21(i, j);
+        }
+    }
+
+    return {{{A11, B11}, {A12, B21}, {S4, B22}, {A22, T4}, {S1, T1}, {S2, T2}, {S3, T3}}};
+}
+
+// Writes C from P1..P7 using Winograd's shared partial sums U2 = P1 + P6 and U3 = U2 + P7.
+template <class T>
+void winograd_combine(const strassen_workspace<T>& ws, matrix_view<T> C) {
+    const std::size_t h = C.rows / 2;
+    auto P1 = ws.p(0), P2 = ws.p(1), P3 = ws.p(2), P4 = ws.p(3), P5 = ws.p(4), P6 = ws.p(5), P7 = ws.p(6);
+    for (std::size_t i = 0; i < h; ++i) {
+        for (std::size_t j = 0; j < h; ++j) {
+            T u2 = P1(i, j) + P6(i, j);
+            T u3 = u2 + P7(i, j);
+            C(i, j) = P1(i, j) + P2(i, j);
+            C(i, j + h) = u2 + P5(i, j) + P3(i, j);
+            C(i + h, j) = u3 - P4(i, j);
+            C(i + h, j + h) = u3 + P5(i, j);
+        }
+    }
+}
+
+template <class T>
+T max_abs(matrix_view<const T> M) {
+    T result = 0;
+    for (std::size_t i = 0; i < M.rows; ++i) {
+        for (std::size_t j = 0; j < M.cols; ++j) result = std::max<T>(result, M(i, j) < 0 ? -M(i, j) : M(i, j));
+    }
+    return result;
+}
+
+template <class T>
+T max_abs_diff(matrix_view<const T> X, matrix_view<const T> Y) {
+    T result = 0;
+    for (std::size_t i = 0; i < X.rows; ++i) {
+        for (std::size_t j = 0; j < X.cols; ++j) result = std::max<T>(result, X(i, j) < Y(i, j) ? Y(i, j) - X(i, j) : X(i, j) - Y(i, j));
+    }
+    return result;
+}
+
+// First-order max-norm forward error bound for Winograd's variant with
+// conventional multiplication on n0 x n0 leaves (Higham, Accuracy and
+// Stability of Numerical Algorithms, 2nd ed., section 23.2.2):
+//   |C - C_hat| <= [(n / n0)^log2(18) (n0^2 + 6 n0) - 6 n] u max|A| max|B|
+// Integer accumulation is exact, so the bound there is zero.
+template <class T>
+T strassen_error_bound(std::size_t n, std::size_t n0, T a_max, T b_max) {
+    if constexpr (std::is_integral_v<T>) {
+        return 0;
+    } else {
+        const T u = std::numeric_limits<T>::epsilon() / 2;
+        const T ratio = static_cast<T>(n) / static_cast<T>(n0);
+        const T growth = std::pow(ratio, std::log2(T(18))) * (T(n0) * T(n0) + 6 * T(n0)) - 6 * T(n);
+        return growth * u * a_max * b_max;
+    }
+}
+
+#endif // GEMM_STRASSEN_HPP
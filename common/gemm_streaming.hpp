@@ -0,0 +1,78 @@
+#ifndef GEMM_STREAMING_HPP
+#define GEMM_STREAMING_HPP
+
+#include "matrix.hpp"
+#include "matrix_file.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Out-of-core C = op(A) * B over matrix files. C is produced one square tile at a
+// time; each tile accumulates over a run of steps that read one tile of A and one
+// of B. The runtimes overlap reading the next step's tiles with computing the
+// current one and write finished C tiles back in the background.
+
+constexpr std::size_t streaming_default_budget_mib = 256;
+
+// Tile edge for a byte budget covering two A and two B tiles (the step being
+// computed and the one being read) and two accumulator tiles (the one being
+// computed and the one being written back). Rounded to the packed kernel's mc.
+template <class T, class Acc>
+std::size_t streaming_tile_size(std::size_t budget_bytes) {
+    const double per_element = 4 * sizeof(T) + 2 * sizeof(Acc);
+    std::size_t tile = static_cast<std::size_t>(std::sqrt(budget_bytes / per_element));
+    return std::max<std::size_t>(64, tile / 64 * 64);
+}
+
+// C(i0.., j0..) += op(A(i0.., k0..)) * B(k0.., j0..) on an m x k by k x n tile pair.
+// first_k steps start a new C tile; last_k steps finish it.
+struct streaming_step {
+    std::size_t i0, j0, k0;
+    std::size_t m, n, k;
+    bool first_k, last_k;
+};
+
+inline std::vector<streaming_step> streaming_steps(std::size_t m, std::size_t n, std::size_t k, std::size_t tile) {
+    std::vector<streaming_step> steps;
+    for (std::size_t i0 = 0; i0 < m; i0 += tile) {
+        for (std::size_t j0 = 0; j0 < n; j0 += tile) {
+            for (std::size_t k0 = 0; k0 < k; k0 += tile) {
+                steps.push_back({i0, j0, k0, std::min(tile, m - i0), std::min(tile, n - j0), std::min(tile, k - k0),
+                                 k0 == 0, k0 + tile >= k});
+            }
+        }
+    }
+    return steps;
+}
+
+// Double-buffered tile storage for the pipeline: slot s of a and b holds the
+// operands of every other step, slot s of c every other C tile.
+template <class T, class Acc>
+struct streaming_buffers {
+    explicit streaming_buffers(std::size_t tile)
+        : a{dense_matrix<T>(tile, tile), dense_matrix<T>(tile, tile)},
+          b{dense_matrix<T>(tile, tile), dense_matrix<T>(tile, tile)},
+          c{dense_matrix<Acc>(tile, tile), dense_matrix<Acc>(tile, tile)} {}
+
+    matrix_view<T> a_tile(int slot, const streaming_step& s) { return a[slot].view().block(0, 0, s.m, s.k); }
+    matrix_view<T> b_tile(int slot, const streaming_step& s) { return b[slot].view().block(0, 0, s.k, s.n); }
+    matrix_view<Acc> c_tile(int slot, const streaming_step& s) { return c[slot].view().block(0, 0, s.m, s.n); }
+
+    dense_matrix<T> a[2];
+    dense_matrix<T> b[2];
+    dense_matrix<Acc> c[2];
+};
+
+// Converts an accumulator tile to the result type one row at a time and writes
+// it to C at (i0, j0), so no second full tile is held.
+template <class Acc, class R>
+void write_back_tile(const matrix_tile_file<R>& C, std::size_t i0, std::size_t j0, matrix_view<const Acc> tile) {
+    std::vector<R> row(tile.cols);
+    for (std::size_t i = 0; i < tile.rows; ++i) {
+        std::transform(tile.row(i), tile.row(i) + tile.cols, row.begin(), [](Acc v) { return static_cast<R>(v); });
+        C.write(i0 + i, j0, matrix_view<const R>{row.data(), 1, tile.cols, tile.cols});
+    }
+}
+
+#endif // GEMM_STREAMING_HPP
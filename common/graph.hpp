@@ -0,0 +1,247 @@
+#ifndef GRAPH_HPP
+#define GRAPH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Undirected graph in CSR form: the neighbours of v are col[row_ptr[v], row_ptr[v + 1]),
+// sorted, without duplicates or self loops. Every edge is stored in both directions.
+struct csr_graph {
+    std::size_t vertices() const noexcept { return row_ptr.size() - 1; }
+    std::size_t degree(std::uint32_t v) const noexcept { return row_ptr[v + 1] - row_ptr[v]; }
+
+    std::vector<std::uint64_t> row_ptr;
+    std::vector<std::uint32_t> col;
+};
+
+inline csr_graph csr_from_edges(std::size_t n, const std::vector<std::pair<std::uint32_t, std::uint32_t>>& edges) {
+    csr_graph g;
+    g.row_ptr.assign(n + 1, 0);
+    for (const auto& [u, v] : edges) {
+        if (u == v) continue;
+        ++g.row_ptr[u + 1];
+        ++g.row_ptr[v + 1];
+    }
+    std::partial_sum(g.row_ptr.begin(), g.row_ptr.end(), g.row_ptr.begin());
+    g.col.resize(g.row_ptr[n]);
+    std::vector<std::uint64_t> next(g.row_ptr.begin(), g.row_ptr.end() - 1);
+    for (const auto& [u, v] : edges) {
+        if (u == v) continue;
+        g.col[next[u]++] = v;
+        g.col[next[v]++] = u;
+    }
+    // Sort and deduplicate each row, compacting in place.
+    std::uint64_t out = 0;
+    for (std::size_t v = 0; v < n; ++v) {
+        auto first = g.col.begin() + g.row_ptr[v], last = g.col.begin() + g.row_ptr[v + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        g.row_ptr[v] = out;
+        out = std::copy(first, last, g.col.begin() + out) - g.col.begin();
+    }
+    g.row_ptr[n] = out;
+    g.col.resize(out);
+    return g;
+}
+
+// R-MAT graph with 2^scale vertices and edge_factor * 2^scale generated edges
+// (Graph500 parameters a = 0.57, b = c = 0.19), with vertex ids shuffled so
+// high-degree vertices are not clustered at low ids.
+inline csr_graph rmat_graph(unsigned scale, std::size_t edge_factor, std::uint64_t seed) {
+    const std::size_t n = std::size_t(1) << scale;
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<std::uint32_t> label(n);
+    std::iota(label.begin(), label.end(), 0);
+    std::shuffle(label.begin(), label.end(), rng);
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges(edge_factor * n);
+    for (auto& e : edges) {
+        std::uint32_t u = 0, v = 0;
+        for (unsigned bit = 0; bit < scale; ++bit) {
+            const double r = uniform(rng);
+            u = (u << 1) | (r >= 0.57 + 0.19 ? 1 : 0);
+            v = (v << 1) | ((r >= 0.57 && r < 0.57 + 0.19) || r >= 0.57 + 0.19 + 0.19 ? 1 : 0);
+        }
+        e = {label[u], label[v]};
+    }
+    return csr_from_edges(n, edges);
+}
+
+// Whitespace-separated "u v" pairs, one per line; lines starting with '#' or '%'
+// are comments. Vertex ids are zero-based and the graph has max id + 1 vertices.
+inline csr_graph load_edge_list(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open " + path);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+    std::size_t n = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#' || line[0] == '%') continue;
+        std::istringstream fields(line);
+        unsigned long long u, v;
+        if (!(fields >> u >> v)) continue;
+        if (std::max(u, v) >= std::numeric_limits<std::uint32_t>::max()) throw std::runtime_error("vertex id too large in " + path);
+        edges.emplace_back(static_cast<std::uint32_t>(u), static_cast<std::uint32_t>(v));
+        n = std::max<std::size_t>(n, std::max(u, v) + 1);
+    }
+    return csr_from_edges(n, edges);
+}
+
+constexpr std::uint32_t unvisited = std::numeric_limits<std::uint32_t>::max();
+
+// BFS tree being built: parent[v] is claimed once, by CAS in top-down steps or by
+// v's own task in bottom-up steps. depth[v] is written by whoever claimed v.
+struct bfs_state {
+    explicit bfs_state(std::size_t n) : parent(n), depth(n), in_frontier(n) {}
+
+    void reset(std::uint32_t root) {
+        for (auto& p : parent) p.store(unvisited, std::memory_order_relaxed);
+        std::fill(depth.begin(), depth.end(), unvisited);
+        parent[root].store(root, std::memory_order_relaxed);
+        depth[root] = 0;
+    }
+
+    std::vector<std::atomic<std::uint32_t>> parent;
+    std::vector<std::uint32_t> depth;
+    std::vector<std::uint8_t> in_frontier; // bottom-up steps only
+};
+
+// Top-down step for frontier[begin, end): claims each unvisited neighbour.
+inline void bfs_top_down(const csr_graph& g, bfs_state& s, const std::vector<std::uint32_t>& frontier, std::size_t begin,
+                         std::size_t end, std::uint32_t level, std::vector<std::uint32_t>& next) {
+    for (std::size_t k = begin; k < end; ++k) {
+        const std::uint32_t u = frontier[k];
+        for (std::uint64_t e = g.row_ptr[u]; e < g.row_ptr[u + 1]; ++e) {
+            const std::uint32_t v = g.col[e];
+            std::uint32_t seen = s.parent[v].load(std::memory_order_relaxed);
+            if (seen == unvisited && s.parent[v].compare_exchange_strong(seen, u, std::memory_order_relaxed)) {
+                s.depth[v] = level;
+                next.push_back(v);
+            }
+        }
+    }
+}
+
+// Bottom-up step for vertices [begin, end): each unvisited one looks for any
+// neighbour in the frontier and stops at the first.
+inline void bfs_bottom_up(const csr_graph& g, bfs_state& s, std::size_t begin, std::size_t end, std::uint32_t level,
+                          std::vector<std::uint32_t>& next) {
+    for (std::size_t v = begin; v < end; ++v) {
+        if (s.parent[v].load(std::memory_order_relaxed) != unvisited) continue;
+        for (std::uint64_t e = g.row_ptr[v]; e < g.row_ptr[v + 1]; ++e) {
+            const std::uint32_t u = g.col[e];
+            if (s.in_frontier[u]) {
+                s.parent[v].store(u, std::memory_order_relaxed);
+                s.depth[v] = level;
+                next.push_back(static_cast<std::uint32_t>(v));
+                break;
+            }
+        }
+    }
+}
+
+// Level-synchronous BFS from root. rt provides the parallelism:
+//   rt.for_blocks(count, f)  calls f(b) for b in [0, count) in parallel and waits;
+//   rt.local()               the calling worker's next-frontier buffer;
+//   rt.gather(out)           appends every worker's buffer to out and clears them.
+// With direction optimisation a step goes bottom-up while the frontier's edges
+// exceed 1/alpha of the unvisited vertices' edges, and back to top-down once the
+// frontier holds fewer than 1/beta of the vertices (Beamer et al.).
+// Returns the depth of the tree; bottom_up_steps, if given, counts bottom-up levels.
+template <class Runtime>
+std::uint32_t bfs_run(Runtime& rt, const csr_graph& g, bfs_state& s, std::uint32_t root, bool direction_optimising,
+                      std::size_t grain, std::size_t* bottom_up_steps = nullptr) {
+    constexpr double alpha = 14, beta = 24;
+    const std::size_t n = g.vertices();
+    s.reset(root);
+    std::vector<std::uint32_t> frontier{root}, next;
+    std::uint64_t unvisited_edges = g.col.size() - g.degree(root), frontier_edges = g.degree(root);
+    bool bottom_up = false;
+    std::uint32_t level = 0;
+    if (bottom_up_steps) *bottom_up_steps = 0;
+
+    while (!frontier.empty()) {
+        ++level;
+        if (direction_optimising) {
+            if (!bottom_up && frontier_edges > unvisited_edges / alpha) {
+                bottom_up = true;
+            } else if (bottom_up && frontier.size() < n / beta) {
+                bottom_up = false;
+            }
+        }
+        if (bottom_up) {
+            rt.for_blocks((frontier.size() + grain - 1) / grain, [&](std::size_t b) {
+                for (std::size_t k = b * grain; k < std::min(frontier.size(), (b + 1) * grain); ++k) s.in_frontier[frontier[k]] = 1;
+            });
+            rt.for_blocks((n + grain - 1) / grain, [&](std::size_t b) {
+                bfs_bottom_up(g, s, b * grain, std::min(n, (b + 1) * grain), level, rt.local());
+            });
+            rt.for_blocks((frontier.size() + grain - 1) / grain, [&](std::size_t b) {
+                for (std::size_t k = b * grain; k < std::min(frontier.size(), (b + 1) * grain); ++k) s.in_frontier[frontier[k]] = 0;
+            });
+            if (bottom_up_steps) ++*bottom_up_steps;
+        } else {
+            rt.for_blocks((frontier.size() + grain - 1) / grain, [&](std::size_t b) {
+                bfs_top_down(g, s, frontier, b * grain, std::min(frontier.size(), (b + 1) * grain), level, rt.local());
+            });
+        }
+        next.clear();
+        rt.gather(next);
+        frontier.swap(next);
+        frontier_edges = 0;
+        for (std::uint32_t v : frontier) frontier_edges += g.degree(v);
+        unvisited_edges -= frontier_edges;
+    }
+    return level - 1;
+}
+
+inline std::vector<std::uint32_t> bfs_serial_depths(const csr_graph& g, std::uint32_t root) {
+    std::vector<std::uint32_t> depth(g.vertices(), unvisited);
+    std::vector<std::uint32_t> queue{root};
+    depth[root] = 0;
+    for (std::size_t k = 0; k < queue.size(); ++k) {
+        const std::uint32_t u = queue[k];
+        for (std::uint64_t e = g.row_ptr[u]; e < g.row_ptr[u + 1]; ++e) {
+            if (depth[g.col[e]] == unvisited) {
+                depth[g.col[e]] = depth[u] + 1;
+                queue.push_back(g.col[e]);
+            }
+        }
+    }
+    return depth;
+}
+
+// A valid BFS tree has the serial depths and every parent is a neighbour one level up.
+inline bool bfs_valid(const csr_graph& g, const bfs_state& s, std::uint32_t root, const std::vector<std::uint32_t>& expected) {
+    if (s.depth != expected) return false;
+    for (std::uint32_t v = 0; v < g.vertices(); ++v) {
+        const std::uint32_t p = s.parent[v].load(std::memory_order_relaxed);
+        if (v == root || p == unvisited) continue;
+        if (s.depth[p] + 1 != s.depth[v]) return false;
+        if (!std::binary_search(g.col.begin() + g.row_ptr[v], g.col.begin() + g.row_ptr[v + 1], p)) return false;
+    }
+    return true;
+}
+
+// Undirected edges in the component reached from the BFS, the Graph500 TEPS numerator.
+inline std::uint64_t bfs_traversed_edges(const csr_graph& g, const bfs_state& s) {
+    std::uint64_t edges = 0;
+    for (std::uint32_t v = 0; v < g.vertices(); ++v) {
+        if (s.depth[v] != unvisited) edges += g.degree(v);
+    }
+    return edges / 2;
+}
+
+#endif // GRAPH_HPP
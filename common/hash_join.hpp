@@ -0,0 +1,142 @@
+#ifndef HASH_JOIN_HPP
+#define HASH_JOIN_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Equi-join of a build relation R with unique keys and a probe relation S whose
+// keys all reference R (primary key - foreign key). Tables are open-addressing
+// arrays of 64-bit slots packing key and payload, so a shared table claims a slot
+// with one CAS. The result is the match count and the sum of both payloads per
+// match, which does not depend on the join order.
+struct join_tuple {
+    std::uint32_t key;
+    std::uint32_t payload;
+};
+
+struct join_result {
+    std::uint64_t matches = 0;
+    std::uint64_t checksum = 0;
+
+    join_result& operator+=(const join_result& other) noexcept {
+        matches += other.matches;
+        checksum += other.checksum;
+        return *this;
+    }
+};
+
+struct join_input {
+    std::vector<join_tuple> r, s;
+};
+
+// |R| = build_size tuples with keys 0 .. build_size - 1 in random order, and
+// |S| = probe_size tuples with uniformly drawn keys of R.
+inline join_input join_relations(std::size_t build_size, std::size_t probe_size, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::uint32_t> payload(0, 1 << 20);
+    std::vector<std::uint32_t> keys(build_size);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    join_input in{std::vector<join_tuple>(build_size), std::vector<join_tuple>(probe_size)};
+    for (std::size_t i = 0; i < build_size; ++i) in.r[i] = {keys[i], payload(rng)};
+    std::uniform_int_distribution<std::uint32_t> key(0, static_cast<std::uint32_t>(build_size - 1));
+    for (auto& t : in.s) t = {key(rng), payload(rng)};
+    return in;
+}
+
+// Serial reference using R's keys as array indices.
+inline join_result join_reference(const join_input& in) {
+    std::vector<std::uint32_t> payload_of(in.r.size());
+    for (const auto& t : in.r) payload_of[t.key] = t.payload;
+    join_result result;
+    for (const auto& t : in.s) result += {1, std::uint64_t(payload_of[t.key]) + t.payload};
+    return result;
+}
+
+inline std::uint64_t join_hash(std::uint32_t key) noexcept {
+    return key * 0x9E3779B97F4A7C15ULL;
+}
+
+// Top bits of the hash pick the partition; the bits below them index the table.
+inline std::size_t join_partition(std::uint32_t key, unsigned bits) noexcept {
+    return bits == 0 ? 0 : static_cast<std::size_t>(join_hash(key) >> (64 - bits));
+}
+
+inline std::size_t join_slot(std::uint32_t key) noexcept {
+    return static_cast<std::size_t>(join_hash(key) >> 20);
+}
+
+inline std::size_t join_capacity(std::size_t tuples) {
+    std::size_t capacity = 16;
+    while (capacity < 2 * tuples) capacity *= 2;
+    return capacity;
+}
+
+constexpr std::uint64_t join_empty = ~std::uint64_t(0);
+
+inline std::uint64_t join_pack(const join_tuple& t) noexcept {
+    return std::uint64_t(t.key) << 32 | t.payload;
+}
+
+// Radix bits so one partition's table stays within a typical L2 (256 KiB).
+inline unsigned join_auto_bits(std::size_t build_size) {
+    unsigned bits = 0;
+    while (join_capacity(build_size >> bits) * sizeof(std::uint64_t) > 256 * 1024) ++bits;
+    return bits;
+}
+
+// Table for one thread, built and probed by the same partition's task.
+struct join_table {
+    explicit join_table(std::size_t tuples = 0) : mask(join_capacity(tuples) - 1), slots(mask + 1, join_empty) {}
+
+    void insert(const join_tuple& t) {
+        std::size_t s = join_slot(t.key) & mask;
+        while (slots[s] != join_empty) s = (s + 1) & mask;
+        slots[s] = join_pack(t);
+    }
+
+    void probe(const join_tuple& t, join_result& result) const {
+        for (std::size_t s = join_slot(t.key) & mask; slots[s] != join_empty; s = (s + 1) & mask) {
+            if (slots[s] >> 32 == t.key) result += {1, (slots[s] & 0xFFFFFFFF) + t.payload};
+        }
+    }
+
+    std::size_t mask;
+    std::vector<std::uint64_t> slots;
+};
+
+// One table for all of R, filled concurrently and probed after the build finishes.
+struct shared_join_table {
+    explicit shared_join_table(std::size_t tuples) : mask(join_capacity(tuples) - 1), slots(mask + 1) {
+        for (auto& s : slots) s.store(join_empty, std::memory_order_relaxed);
+    }
+
+    void insert(const join_tuple& t) {
+        const std::uint64_t packed = join_pack(t);
+        for (std::size_t s = join_slot(t.key) & mask;; s = (s + 1) & mask) {
+            std::uint64_t seen = join_empty;
+            if (slots[s].load(std::memory_order_relaxed) == join_empty &&
+                slots[s].compare_exchange_strong(seen, packed, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    void probe(const join_tuple& t, join_result& result) const {
+        for (std::size_t s = join_slot(t.key) & mask;; s = (s + 1) & mask) {
+            const std::uint64_t slot = slots[s].load(std::memory_order_relaxed);
+            if (slot == join_empty) return;
+            if (slot >> 32 == t.key) result += {1, (slot & 0xFFFFFFFF) + t.payload};
+        }
+    }
+
+    std::size_t mask;
+    std::vector<std::atomic<std::uint64_t>> slots;
+};
+
+#endif // HASH_JOIN_HPP
@@ -0,0 +1,91 @@
+#ifndef IRREGULAR_HPP
+#define IRREGULAR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Loops whose iterations cost very different amounts, for comparing how
+// schedules balance them. Each kernel returns the work it did in its own units
+// (escape-time iterations, spin units), which is what per-worker load is measured in.
+
+// Escape-time iterations for every pixel of row y of a width x height image of
+// [-2, 1] x [-1.5, 1.5]; rows through the set cost up to max_iter per pixel,
+// rows far from it a handful.
+struct mandelbrot_image {
+    mandelbrot_image(std::size_t width, std::size_t height, std::uint32_t max_iter)
+        : width(width), height(height), max_iter(max_iter), iterations(width * height) {}
+
+    std::uint64_t row(std::size_t y) {
+        const double ci = -1.5 + 3.0 * (static_cast<double>(y) + 0.5) / static_cast<double>(height);
+        std::uint64_t work = 0;
+        for (std::size_t x = 0; x < width; ++x) {
+            const double cr = -2.0 + 3.0 * (static_cast<double>(x) + 0.5) / static_cast<double>(width);
+            double zr = 0, zi = 0;
+            std::uint32_t k = 0;
+            while (k < max_iter && zr * zr + zi * zi <= 4.0) {
+                const double t = zr * zr - zi * zi + cr;
+                zi = 2 * zr * zi + ci;
+                zr = t;
+                ++k;
+            }
+            iterations[y * width + x] = k;
+            work += k + 1;
+        }
+        return work;
+    }
+
+    std::size_t width, height;
+    std::uint32_t max_iter;
+    std::vector<std::uint32_t> iterations;
+};
+
+// Spin units per index for n indices averaging about `cost`:
+//   uniform - every index costs the same
+//   linear  - cost grows from 0 to 2 * cost across the range
+//   spike   - 1 in 100 indices costs 50x, the rest 0.5x
+//   random  - exponentially distributed, so a few indices are several times the mean
+inline std::vector<std::uint32_t> cost_profile(const std::string& pattern, std::size_t n, std::uint32_t cost, std::uint64_t seed) {
+    std::vector<std::uint32_t> units(n, cost);
+    std::mt19937_64 rng(seed);
+    std::exponential_distribution<double> exponential(1.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (pattern == "linear") {
+            units[i] = static_cast<std::uint32_t>(2.0 * cost * static_cast<double>(i) / static_cast<double>(n));
+        } else if (pattern == "spike") {
+            units[i] = i % 100 == 0 ? 50 * cost : cost / 2;
+        } else if (pattern == "random") {
+            units[i] = static_cast<std::uint32_t>(cost * exponential(rng));
+        }
+    }
+    return units;
+}
+
+inline bool known_cost_pattern(const std::string& pattern) {
+    return pattern == "uniform" || pattern == "linear" || pattern == "spike" || pattern == "random";
+}
+
+// A dependent chain of `units` multiply-adds, so cost is compute time with no memory traffic.
+inline double spin(std::uint32_t units, double seed) {
+    double x = seed;
+    for (std::uint32_t u = 0; u < units; ++u) x = x * 0.999999 + 1e-6;
+    return x;
+}
+
+// The largest per-worker load over the mean across `workers` workers; 1 is a
+// perfect balance. loads may hold extra zero entries for threads that did no work.
+inline double load_imbalance(const std::vector<double>& loads, std::size_t workers) {
+    double total = 0, most = 0;
+    for (double l : loads) {
+        total += l;
+        most = std::max(most, l);
+    }
+    return total > 0 ? most * static_cast<double>(workers) / total : 1.0;
+}
+
+#endif // IRREGULAR_HPP
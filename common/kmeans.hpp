@@ -0,0 +1,117 @@
+#ifndef KMEANS_HPP
+#define KMEANS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Lloyd's k-means on n points of d float coordinates. Points are stored one
+// coordinate array after another (x[j * n + i] is coordinate j of point i), so the
+// distance loop runs over consecutive points of a block and vectorises across them.
+struct point_set {
+    std::size_t n, d;
+    std::vector<float> x;
+
+    const float* coord(std::size_t j) const noexcept { return x.data() + j * n; }
+};
+
+// n points around k Gaussian blobs with centres uniform in [-10, 10]^d.
+inline point_set gaussian_blobs(std::size_t n, std::size_t d, std::size_t k, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<float> centre(-10, 10);
+    std::normal_distribution<float> noise(0, 1);
+    std::uniform_int_distribution<std::size_t> blob(0, k - 1);
+    std::vector<float> centres(k * d);
+    for (auto& c : centres) c = centre(rng);
+    point_set p{n, d, std::vector<float>(n * d)};
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t b = blob(rng);
+        for (std::size_t j = 0; j < d; ++j) p.x[j * n + i] = centres[b * d + j] + noise(rng);
+    }
+    return p;
+}
+
+// k distinct random points as the starting centroids, k x d row-major.
+inline std::vector<float> initial_centroids(const point_set& p, std::size_t k, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::size_t> picked;
+    std::uniform_int_distribution<std::size_t> pick(0, p.n - 1);
+    while (picked.size() < std::min(k, p.n)) {
+        const std::size_t i = pick(rng);
+        if (std::find(picked.begin(), picked.end(), i) == picked.end()) picked.push_back(i);
+    }
+    std::vector<float> centroids(k * p.d);
+    for (std::size_t c = 0; c < k; ++c) {
+        for (std::size_t j = 0; j < p.d; ++j) centroids[c * p.d + j] = p.coord(j)[picked[c % picked.size()]];
+    }
+    return centroids;
+}
+
+// Per-cluster coordinate sums and counts from one worker's share of an assign step.
+struct kmeans_partial {
+    kmeans_partial(std::size_t k = 0, std::size_t d = 0) : d(d), sums(k * d), counts(k) {}
+
+    void merge(const kmeans_partial& other) {
+        for (std::size_t s = 0; s < sums.size(); ++s) sums[s] += other.sums[s];
+        for (std::size_t c = 0; c < counts.size(); ++c) counts[c] += other.counts[c];
+        changed += other.changed;
+        inertia += other.inertia;
+    }
+
+    std::size_t d;
+    std::vector<double> sums;
+    std::vector<std::uint64_t> counts;
+    std::uint64_t changed = 0; // points whose cluster changed
+    double inertia = 0;        // sum of squared distances to the assigned centroid
+};
+
+constexpr std::size_t kmeans_block = 256;
+
+// Assigns points [begin, end), at most kmeans_block of them, to their nearest
+// centroid and adds them to acc.
+inline void kmeans_assign(const point_set& p, const std::vector<float>& centroids, std::size_t k, std::size_t begin, std::size_t end,
+                          std::vector<std::uint32_t>& labels, kmeans_partial& acc) {
+    const std::size_t m = end - begin;
+    float dist[kmeans_block], best[kmeans_block];
+    std::uint32_t label[kmeans_block];
+    std::fill_n(best, m, std::numeric_limits<float>::max());
+    std::fill_n(label, m, 0);
+    for (std::size_t c = 0; c < k; ++c) {
+        std::fill_n(dist, m, 0.0f);
+        for (std::size_t j = 0; j < p.d; ++j) {
+            const float* x = p.coord(j) + begin;
+            const float centre = centroids[c * p.d + j];
+            for (std::size_t i = 0; i < m; ++i) {
+                const float diff = x[i] - centre;
+                dist[i] += diff * diff;
+            }
+        }
+        for (std::size_t i = 0; i < m; ++i) {
+            label[i] = dist[i] < best[i] ? static_cast<std::uint32_t>(c) : label[i];
+            best[i] = std::min(best[i], dist[i]);
+        }
+    }
+    for (std::size_t i = 0; i < m; ++i) {
+        const std::uint32_t c = label[i];
+        if (labels[begin + i] != c) ++acc.changed;
+        labels[begin + i] = c;
+        ++acc.counts[c];
+        acc.inertia += best[i];
+        for (std::size_t j = 0; j < p.d; ++j) acc.sums[c * p.d + j] += p.coord(j)[begin + i];
+    }
+}
+
+// New centroids from the merged sums; an empty cluster keeps its centroid.
+inline void kmeans_update(const kmeans_partial& total, std::vector<float>& centroids) {
+    for (std::size_t c = 0; c < total.counts.size(); ++c) {
+        if (total.counts[c] == 0) continue;
+        for (std::size_t j = 0; j < total.d; ++j) {
+            centroids[c * total.d + j] = static_cast<float>(total.sums[c * total.d + j] / static_cast<double>(total.counts[c]));
+        }
+    }
+}
+
+#endif // KMEANS_HPP
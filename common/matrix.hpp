@@ -0,0 +1,104 @@
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+constexpr std::size_t cache_line_size = 64;
+
+// Owning, cache-line aligned, uninitialised storage for trivially copyable T.
+template <class T>
+class aligned_buffer {
+    static_assert(std::is_trivially_copyable_v<T>, "aligned_buffer only holds trivially copyable types");
+
+public:
+    aligned_buffer() = default;
+    explicit aligned_buffer(std::size_t n) { reserve(n); }
+
+    // Grows the buffer to at least n elements; existing contents are not preserved.
+    void reserve(std::size_t n) {
+        if (n <= capacity) return;
+        std::size_t bytes = (n * sizeof(T) + cache_line_size - 1) / cache_line_size * cache_line_size;
+        void* p = std::aligned_alloc(cache_line_size, bytes);
+        if (!p) throw std::bad_alloc();
+        storage.reset(static_cast<T*>(p));
+        capacity = n;
+    }
+
+    T* data() const noexcept { return storage.get(); }
+    std::size_t size() const noexcept { return capacity; }
+
+private:
+    struct free_deleter {
+        void operator()(T* p) const noexcept { std::free(p); }
+    };
+    std::unique_ptr<T, free_deleter> storage;
+    std::size_t capacity = 0;
+};
+
+// Non-owning row-major view; stride is the distance in elements between rows.
+template <class T>
+struct matrix_view {
+    T* data = nullptr;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::size_t stride = 0;
+
+    T& operator()(std::size_t i, std::size_t j) const noexcept { return data[i * stride + j]; }
+    T* row(std::size_t i) const noexcept { return data + i * stride; }
+
+    matrix_view block(std::size_t r0, std::size_t c0, std::size_t nr, std::size_t nc) const noexcept {
+        return {row(r0) + c0, nr, nc, stride};
+    }
+
+    operator matrix_view<const T>() const noexcept { return {data, rows, cols, stride}; }
+};
+
+// Tag for constructing a dense_matrix whose elements are left unwritten, so the
+// pages are first touched by whoever initialises them.
+struct uninitialized_t {
+    explicit uninitialized_t() = default;
+};
+inline constexpr uninitialized_t uninitialized{};
+
+// Contiguous row-major matrix whose rows start on cache-line boundaries.
+template <class T>
+class dense_matrix {
+public:
+    dense_matrix() = default;
+
+    dense_matrix(std::size_t rows, std::size_t cols, uninitialized_t)
+        : n_rows(rows), n_cols(cols), row_stride(padded_stride(cols)), storage(rows * row_stride) {}
+
+    dense_matrix(std::size_t rows, std::size_t cols, T value = T{})
+        : n_rows(rows), n_cols(cols), row_stride(padded_stride(cols)), storage(rows * row_stride) {
+        std::fill_n(storage.data(), rows * row_stride, value);
+    }
+
+    std::size_t rows() const noexcept { return n_rows; }
+    std::size_t cols() const noexcept { return n_cols; }
+    std::size_t stride() const noexcept { return row_stride; }
+
+    T& operator()(std::size_t i, std::size_t j) noexcept { return storage.data()[i * row_stride + j]; }
+    const T& operator()(std::size_t i, std::size_t j) const noexcept { return storage.data()[i * row_stride + j]; }
+
+    matrix_view<T> view() noexcept { return {storage.data(), n_rows, n_cols, row_stride}; }
+    matrix_view<const T> view() const noexcept { return {storage.data(), n_rows, n_cols, row_stride}; }
+
+private:
+    static std::size_t padded_stride(std::size_t cols) {
+        constexpr std::size_t per_line = std::max<std::size_t>(1, cache_line_size / sizeof(T));
+        return (cols + per_line - 1) / per_line * per_line;
+    }
+
+    std::size_t n_rows = 0;
+    std::size_t n_cols = 0;
+    std::size_t row_stride = 0;
+    aligned_buffer<T> storage;
+};
+
+#endif // MATRIX_HPP
@@ -0,0 +1,340 @@
+#ifndef MATRIX_FILE_HPP
+#define MATRIX_FILE_HPP
+
+#include "element_types.hpp"
+#include "matrix.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binary matrix file: one header page followed by rows * stride elements in
+// row-major order. Data starts on a page boundary and every row starts on an
+// `alignment`-byte boundary, so a read-only mapping of the file can be used as a
+// matrix_view directly, without copying.
+constexpr std::size_t matrix_file_page_size = 4096;
+
+enum class matrix_dtype : std::uint32_t { int8 = 1, int16 = 2, int32 = 3, float32 = 4, float64 = 5 };
+
+template <class T>
+constexpr matrix_dtype dtype_of() {
+    if constexpr (std::is_same_v<T, std::int8_t>) return matrix_dtype::int8;
+    else if constexpr (std::is_same_v<T, std::int16_t>) return matrix_dtype::int16;
+    else if constexpr (std::is_same_v<T, std::int32_t>) return matrix_dtype::int32;
+    else if constexpr (std::is_same_v<T, float>) return matrix_dtype::float32;
+    else {
+        static_assert(std::is_same_v<T, double>, "no matrix_dtype for this element type");
+        return matrix_dtype::float64;
+    }
+}
+
+struct matrix_file_header {
+    char magic[8] = {'P', '2', '0', '7', '9', 'M', 'A', 'T'};
+    std::uint32_t version = 1;
+    std::uint32_t byte_order = 0x01020304; // Read back differently on a foreign-endian host
+    std::uint32_t dtype = 0;
+    std::uint32_t alignment = 0;           // Byte alignment of every row start
+    std::uint64_t rows = 0;
+    std::uint64_t cols = 0;
+    std::uint64_t stride = 0;              // Elements between row starts
+    std::uint64_t data_offset = 0;         // Byte offset of row 0, a multiple of the page size
+    std::uint64_t reserved = 0;
+};
+static_assert(sizeof(matrix_file_header) == 64, "matrix_file_header layout must not change");
+
+// Header for a rows x cols matrix of T with rows padded to cache_line_size,
+// the layout dense_matrix uses.
+template <class T>
+matrix_file_header make_matrix_header(std::size_t rows, std::size_t cols) {
+    constexpr std::size_t per_line = std::max<std::size_t>(1, cache_line_size / sizeof(T));
+    matrix_file_header header;
+    header.dtype = static_cast<std::uint32_t>(dtype_of<T>());
+    header.alignment = cache_line_size;
+    header.rows = rows;
+    header.cols = cols;
+    header.stride = (cols + per_line - 1) / per_line * per_line;
+    header.data_offset = matrix_file_page_size;
+    return header;
+}
+
+namespace matrix_file_detail {
+
+// Parses the header of a version 1-3 .npy file (C order, little-endian) and
+// returns its data offset, filling rows/cols and checking the dtype matches T.
+template <class T>
+std::size_t parse_npy_header(const unsigned char* base, std::size_t size, std::uint64_t& rows, std::uint64_t& cols) {
+    if (size < 10) throw std::runtime_error(".npy file too short");
+    const std::size_t length_bytes = base[6] == 1 ? 2 : 4;
+    if (size < 8 + length_bytes) throw std::runtime_error(".npy file too short");
+    std::size_t header_len = base[8] | (base[9] << 8);
+    if (length_bytes == 4) header_len |= (static_cast<std::size_t>(base[10]) << 16) | (static_cast<std::size_t>(base[11]) << 24);
+    const std::size_t offset = 8 + length_bytes + header_len;
+    if (offset > size) throw std::runtime_error(".npy header runs past end of file");
+    const std::string dict(reinterpret_cast<const char*>(base) + 8 + length_bytes, header_len);
+
+    auto value_of = [&dict](const std::string& key) {
+        auto pos = dict.find("'" + key + "'");
+        if (pos == std::string::npos) throw std::runtime_error(".npy header has no " + key);
+        pos = dict.find(':', pos);
+        pos = dict.find_first_not_of(' ', pos + 1);
+        return dict.substr(pos);
+    };
+
+    static const char* descr_for[] = {"", "i1", "<i2", "<i4", "<f4", "<f8"};
+    const std::string descr = value_of("descr");
+    const std::string expected = descr_for[static_cast<std::uint32_t>(dtype_of<T>())];
+    if (descr.find(expected) == std::string::npos) {
+        throw std::runtime_error(".npy dtype " + descr.substr(0, descr.find(',')) + " does not match " + element_traits<T>::name);
+    }
+    if (value_of("fortran_order").find("True") < value_of("fortran_order").find(',')) {
+        throw std::runtime_error("Fortran-ordered .npy files are not supported");
+    }
+
+    const std::string shape = value_of("shape");
+    const auto open = shape.find('('), close = shape.find(')');
+    std::vector<std::uint64_t> dims;
+    for (std::size_t pos = open + 1; pos < close;) {
+        while (pos < close && (shape[pos] == ' ' || shape[pos] == ',')) ++pos;
+        if (pos >= close) break;
+        std::size_t used = 0;
+        dims.push_back(std::stoull(shape.substr(pos, close - pos), &used));
+        pos += used;
+    }
+    if (dims.empty() || dims.size() > 2) throw std::runtime_error(".npy array must be 1- or 2-dimensional");
+    rows = dims.size() == 2 ? dims[0] : 1;
+    cols = dims.back();
+    return offset;
+}
+
+struct matrix_layout {
+    std::uint64_t rows = 0;
+    std::uint64_t cols = 0;
+    std::uint64_t stride = 0;
+    std::uint64_t offset = 0;
+};
+
+// Reads the layout of a .mat or .npy file from its first head_size bytes.
+template <class T>
+matrix_layout parse_matrix_layout(const unsigned char* head, std::size_t head_size, std::size_t file_size, const std::string& path) {
+    matrix_layout layout;
+    if (head_size >= 6 && std::memcmp(head, "\x93NUMPY", 6) == 0) {
+        layout.offset = parse_npy_header<T>(head, head_size, layout.rows, layout.cols);
+        layout.stride = layout.cols;
+    } else {
+        matrix_file_header header;
+        if (head_size < sizeof(header)) throw std::runtime_error(path + " is too short for a matrix header");
+        std::memcpy(&header, head, sizeof(header));
+        if (std::memcmp(header.magic, matrix_file_header{}.magic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error(path + " is neither a matrix file nor a .npy file");
+        }
+        if (header.byte_order != matrix_file_header{}.byte_order) throw std::runtime_error(path + " has foreign byte order");
+        if (header.dtype != static_cast<std::uint32_t>(dtype_of<T>())) {
+            throw std::runtime_error(path + " does not hold " + element_traits<T>::name + " elements");
+        }
+        layout = {header.rows, header.cols, header.stride, header.data_offset};
+    }
+
+    if (layout.offset % alignof(T) != 0) throw std::runtime_error(path + " has misaligned data");
+    // Divides rather than multiplies so a forged rows or stride cannot overflow past the check.
+    if (layout.stride < layout.cols || layout.offset > file_size ||
+        (layout.stride != 0 && layout.rows > (file_size - layout.offset) / sizeof(T) / layout.stride)) {
+        throw std::runtime_error(path + " is smaller than its header claims");
+    }
+    return layout;
+}
+
+} // namespace matrix_file_detail
+
+// Read-only mapping of a matrix file (this format or .npy) exposed as a matrix_view.
+template <class T>
+class mapped_matrix {
+public:
+    mapped_matrix() = default;
+
+    explicit mapped_matrix(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path);
+        }
+        length = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("cannot map " + path);
+        base = static_cast<const unsigned char*>(p);
+
+        try {
+            parse(path);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    mapped_matrix(const mapped_matrix&) = delete;
+    mapped_matrix& operator=(const mapped_matrix&) = delete;
+
+    mapped_matrix(mapped_matrix&& other) noexcept { *this = std::move(other); }
+
+    mapped_matrix& operator=(mapped_matrix&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            base = std::exchange(other.base, nullptr);
+            length = std::exchange(other.length, 0);
+            matrix = std::exchange(other.matrix, {});
+        }
+        return *this;
+    }
+
+    ~mapped_matrix() { unmap(); }
+
+    matrix_view<const T> view() const noexcept { return matrix; }
+
+private:
+    void parse(const std::string& path) {
+        auto layout = matrix_file_detail::parse_matrix_layout<T>(base, length, length, path);
+        matrix = {reinterpret_cast<const T*>(base + layout.offset), layout.rows, layout.cols, layout.stride};
+    }
+
+    void unmap() noexcept {
+        if (base) ::munmap(const_cast<unsigned char*>(base), length);
+        base = nullptr;
+        length = 0;
+    }
+
+    const unsigned char* base = nullptr;
+    std::size_t length = 0;
+    matrix_view<const T> matrix;
+};
+
+// Positioned reads and writes of rectangular tiles of a matrix file, for operands
+// too large to map or hold in memory. Calls from several threads may overlap as
+// long as concurrently written tiles are disjoint.
+template <class T>
+class matrix_tile_file {
+public:
+    explicit matrix_tile_file(const std::string& path, bool writable = false) : path(path) {
+        fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open " + path);
+        try {
+            struct stat st;
+            if (::fstat(fd, &st) != 0) throw std::runtime_error("cannot stat " + path);
+            std::vector<unsigned char> head(std::min<std::size_t>(st.st_size, 16 * matrix_file_page_size));
+            transfer(::pread, head.data(), head.size(), 0);
+            layout = matrix_file_detail::parse_matrix_layout<T>(head.data(), head.size(), st.st_size, path);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    matrix_tile_file(const matrix_tile_file&) = delete;
+    matrix_tile_file& operator=(const matrix_tile_file&) = delete;
+
+    ~matrix_tile_file() { ::close(fd); }
+
+    std::size_t rows() const noexcept { return layout.rows; }
+    std::size_t cols() const noexcept { return layout.cols; }
+
+    // Reads the dst.rows x dst.cols tile whose top-left element is (r0, c0).
+    void read(std::size_t r0, std::size_t c0, matrix_view<T> dst) const {
+        for (std::size_t i = 0; i < dst.rows; ++i) {
+            transfer(::pread, dst.row(i), dst.cols * sizeof(T), element_offset(r0 + i, c0));
+        }
+    }
+
+    void write(std::size_t r0, std::size_t c0, matrix_view<const T> src) const {
+        for (std::size_t i = 0; i < src.rows; ++i) {
+            transfer(::pwrite, src.row(i), src.cols * sizeof(T), element_offset(r0 + i, c0));
+        }
+    }
+
+private:
+    off_t element_offset(std::size_t i, std::size_t j) const noexcept {
+        return static_cast<off_t>(layout.offset + (i * layout.stride + j) * sizeof(T));
+    }
+
+    // Repeats pread/pwrite until all bytes are transferred; both may stop short.
+    template <class Call, class Buffer>
+    void transfer(Call call, Buffer* buffer, std::size_t bytes, off_t offset) const {
+        auto* p = reinterpret_cast<std::conditional_t<std::is_const_v<Buffer>, const char*, char*>>(buffer);
+        while (bytes > 0) {
+            ssize_t done = call(fd, p, bytes, offset);
+            if (done <= 0) throw std::runtime_error("I/O error on " + path);
+            p += done;
+            bytes -= static_cast<std::size_t>(done);
+            offset += done;
+        }
+    }
+
+    std::string path;
+    int fd = -1;
+    matrix_file_detail::matrix_layout layout;
+};
+
+// Creates (or truncates) a rows x cols matrix file of zeros without writing the
+// data, so files larger than memory can be produced tile by tile.
+template <class T>
+void create_matrix_file(const std::string& path, std::size_t rows, std::size_t cols) {
+    matrix_file_header header = make_matrix_header<T>(rows, cols);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("cannot create " + path);
+    bool ok = ::pwrite(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+              ::ftruncate(fd, static_cast<off_t>(header.data_offset + rows * header.stride * sizeof(T))) == 0;
+    ::close(fd);
+    if (!ok) throw std::runtime_error("cannot size " + path);
+}
+
+template <class T>
+void write_matrix_file(const std::string& path, matrix_view<const T> M) {
+    create_matrix_file<T>(path, M.rows, M.cols);
+    matrix_tile_file<T>(path, true).write(0, 0, M);
+}
+
+// Writes a rows x cols matrix filled with value one row at a time.
+template <class T>
+void fill_matrix_file(const std::string& path, std::size_t rows, std::size_t cols, T value) {
+    create_matrix_file<T>(path, rows, cols);
+    matrix_tile_file<T> file(path, true);
+    std::vector<T> row(cols, value);
+    for (std::size_t i = 0; i < rows; ++i) {
+        file.write(i, 0, matrix_view<const T>{row.data(), 1, cols, cols});
+    }
+}
+
+// A benchmark operand: either a file mapped without copying or the dense_matrix
+// returned by generate().
+template <class T>
+class input_matrix {
+public:
+    template <class Generate>
+    input_matrix(const std::string& path, Generate&& generate) {
+        if (path.empty()) {
+            owned = generate();
+            matrix = owned.view();
+        } else {
+            mapped = mapped_matrix<T>(path);
+            matrix = mapped.view();
+        }
+    }
+
+    matrix_view<const T> view() const noexcept { return matrix; }
+
+private:
+    dense_matrix<T> owned;
+    mapped_matrix<T> mapped;
+    matrix_view<const T> matrix;
+};
+
+#endif // MATRIX_FILE_HPP
@@ -0,0 +1,128 @@
+#ifndef MONTE_CARLO_HPP
+#define MONTE_CARLO_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Monte Carlo kernels drawing from Philox4x32-10, a counter-based generator: the
+// random words for a sample are a pure function of (seed, block, sample index),
+// so every block of samples has its own stream with no generator state to share
+// or seed, and a result does not depend on which worker ran which block.
+// Blocks keep their partial sums in block order and are added up serially, so
+// parallel runs reproduce the serial result bit for bit.
+
+// Counters are generated in groups of philox_lanes, each Philox round applied to
+// the whole group at once so the loops vectorise.
+constexpr std::size_t philox_lanes = 16;
+
+using philox_words = std::uint32_t[4][philox_lanes];
+
+// Philox4x32-10 of the counters (first + l, block) for l < philox_lanes under key seed.
+inline void philox_block(std::uint64_t seed, std::uint64_t block, std::uint64_t first, philox_words& out) {
+    std::uint32_t c0[philox_lanes], c1[philox_lanes], c2[philox_lanes], c3[philox_lanes];
+    for (std::size_t l = 0; l < philox_lanes; ++l) {
+        c0[l] = static_cast<std::uint32_t>(first + l);
+        c1[l] = static_cast<std::uint32_t>((first + l) >> 32);
+        c2[l] = static_cast<std::uint32_t>(block);
+        c3[l] = static_cast<std::uint32_t>(block >> 32);
+    }
+    std::uint32_t k0 = static_cast<std::uint32_t>(seed), k1 = static_cast<std::uint32_t>(seed >> 32);
+    for (int round = 0; round < 10; ++round) {
+        for (std::size_t l = 0; l < philox_lanes; ++l) {
+            const std::uint64_t p0 = std::uint64_t(0xD2511F53) * c0[l], p1 = std::uint64_t(0xCD9E8D57) * c2[l];
+            const std::uint32_t hi0 = static_cast<std::uint32_t>(p0 >> 32), hi1 = static_cast<std::uint32_t>(p1 >> 32);
+            c0[l] = hi1 ^ c1[l] ^ k0;
+            c2[l] = hi0 ^ c3[l] ^ k1;
+            c1[l] = static_cast<std::uint32_t>(p1);
+            c3[l] = static_cast<std::uint32_t>(p0);
+        }
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+    for (std::size_t l = 0; l < philox_lanes; ++l) {
+        out[0][l] = c0[l];
+        out[1][l] = c1[l];
+        out[2][l] = c2[l];
+        out[3][l] = c3[l];
+    }
+}
+
+// A random word mapped to the open interval (0, 1).
+inline double unit_interval(std::uint32_t word) noexcept {
+    return (word + 0.5) * 0x1p-32;
+}
+
+// Number of samples in a block: block_size, except the last block takes the remainder.
+inline std::size_t block_samples(std::size_t samples, std::size_t block_size, std::size_t block) {
+    return std::min(block_size, samples - block * block_size);
+}
+
+// Points of block `block` that fall inside the quarter unit circle, out of
+// `count`; each counter gives two points.
+inline std::uint64_t pi_block(std::uint64_t seed, std::uint64_t block, std::size_t count) {
+    std::uint64_t inside = 0;
+    philox_words w;
+    for (std::size_t s = 0; s < count; s += 2 * philox_lanes) {
+        philox_block(seed, block, s / 2, w);
+        const std::size_t valid = count - s;
+        for (std::size_t l = 0; l < philox_lanes; ++l) {
+            const double x0 = unit_interval(w[0][l]), y0 = unit_interval(w[1][l]);
+            const double x1 = unit_interval(w[2][l]), y1 = unit_interval(w[3][l]);
+            inside += static_cast<std::uint64_t>(x0 * x0 + y0 * y0 <= 1.0 && 2 * l < valid);
+            inside += static_cast<std::uint64_t>(x1 * x1 + y1 * y1 <= 1.0 && 2 * l + 1 < valid);
+        }
+    }
+    return inside;
+}
+
+// A European call on one asset following geometric Brownian motion.
+struct option_params {
+    double spot = 100, strike = 100, rate = 0.05, volatility = 0.2, years = 1;
+};
+
+inline double black_scholes_call(const option_params& p) {
+    const double sd = p.volatility * std::sqrt(p.years);
+    const double d1 = (std::log(p.spot / p.strike) + (p.rate + 0.5 * p.volatility * p.volatility) * p.years) / sd, d2 = d1 - sd;
+    auto normal_cdf = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+    return p.spot * normal_cdf(d1) - p.strike * std::exp(-p.rate * p.years) * normal_cdf(d2);
+}
+
+// Sum and sum of squares of the undiscounted payoffs of one block's paths.
+struct payoff_sum {
+    double sum = 0, sum_sq = 0;
+
+    payoff_sum& operator+=(const payoff_sum& other) noexcept {
+        sum += other.sum;
+        sum_sq += other.sum_sq;
+        return *this;
+    }
+};
+
+// Payoffs of `count` terminal prices of block `block`; each counter gives two
+// Box-Muller pairs, so four paths.
+inline payoff_sum option_block(std::uint64_t seed, std::uint64_t block, std::size_t count, const option_params& p) {
+    const double drift = (p.rate - 0.5 * p.volatility * p.volatility) * p.years, sd = p.volatility * std::sqrt(p.years);
+    const double two_pi = 6.283185307179586;
+    payoff_sum total;
+    philox_words w;
+    for (std::size_t s = 0; s < count; s += 4 * philox_lanes) {
+        philox_block(seed, block, s / 4, w);
+        const std::size_t valid = count - s;
+        for (std::size_t l = 0; l < philox_lanes; ++l) {
+            const double r0 = std::sqrt(-2.0 * std::log(unit_interval(w[0][l]))), a0 = two_pi * unit_interval(w[1][l]);
+            const double r1 = std::sqrt(-2.0 * std::log(unit_interval(w[2][l]))), a1 = two_pi * unit_interval(w[3][l]);
+            const double z[4] = {r0 * std::cos(a0), r0 * std::sin(a0), r1 * std::cos(a1), r1 * std::sin(a1)};
+            for (std::size_t k = 0; k < 4; ++k) {
+                const double payoff = 4 * l + k < valid ? std::max(0.0, p.spot * std::exp(drift + sd * z[k]) - p.strike) : 0.0;
+                total.sum += payoff;
+                total.sum_sq += payoff * payoff;
+            }
+        }
+    }
+    return total;
+}
+
+#endif // MONTE_CARLO_HPP
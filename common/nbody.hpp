@@ -0,0 +1,213 @@
+#ifndef NBODY_HPP
+#define NBODY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Gravitational N-body (G = 1) with Plummer softening, particles stored as
+// separate arrays per component so the direct-summation inner loop streams
+// unit-stride data.
+constexpr double nbody_softening2 = 1e-4;
+
+struct particles {
+    explicit particles(std::size_t n) : x(n), y(n), z(n), vx(n), vy(n), vz(n), ax(n), ay(n), az(n), m(n) {}
+
+    std::size_t size() const noexcept { return x.size(); }
+
+    std::vector<double> x, y, z;
+    std::vector<double> vx, vy, vz;
+    std::vector<double> ax, ay, az;
+    std::vector<double> m;
+};
+
+// n equal-mass particles at rest in a Plummer sphere of scale radius 1: dense in
+// the core and sparse in the halo, so the work per particle in a tree code varies
+// by orders of magnitude.
+inline particles plummer_sphere(std::size_t n, std::uint64_t seed) {
+    particles p(n);
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    const double two_pi = 6.283185307179586;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double u = std::max(uniform(rng), 1e-6);
+        const double r = std::min(1 / std::sqrt(std::pow(u, -2.0 / 3) - 1), 50.0);
+        const double cos_theta = 2 * uniform(rng) - 1, phi = two_pi * uniform(rng);
+        const double sin_theta = std::sqrt(1 - cos_theta * cos_theta);
+        p.x[i] = r * sin_theta * std::cos(phi);
+        p.y[i] = r * sin_theta * std::sin(phi);
+        p.z[i] = r * cos_theta;
+        p.m[i] = 1.0 / n;
+    }
+    return p;
+}
+
+// Acceleration of particle i from every particle; i itself contributes nothing.
+inline void direct_accel(particles& p, std::size_t i) {
+    const double xi = p.x[i], yi = p.y[i], zi = p.z[i];
+    double ax = 0, ay = 0, az = 0;
+    for (std::size_t j = 0; j < p.size(); ++j) {
+        const double dx = p.x[j] - xi, dy = p.y[j] - yi, dz = p.z[j] - zi;
+        const double r2 = dx * dx + dy * dy + dz * dz + nbody_softening2;
+        const double s = p.m[j] / (r2 * std::sqrt(r2));
+        ax += dx * s;
+        ay += dy * s;
+        az += dz * s;
+    }
+    p.ax[i] = ax;
+    p.ay[i] = ay;
+    p.az[i] = az;
+}
+
+// Leapfrog (kick-drift) update of particle i.
+inline void nbody_advance(particles& p, std::size_t i, double dt) {
+    p.vx[i] += p.ax[i] * dt;
+    p.vy[i] += p.ay[i] * dt;
+    p.vz[i] += p.az[i] * dt;
+    p.x[i] += p.vx[i] * dt;
+    p.y[i] += p.vy[i] * dt;
+    p.z[i] += p.vz[i] * dt;
+}
+
+// Barnes-Hut octree. A node covers a cube and the particles order[first, first + count);
+// children exist only for non-empty octants. Nodes are allocated by whichever task
+// splits their parent, so the tree can be built in parallel.
+struct bh_node {
+    bh_node(double cx, double cy, double cz, double half, std::size_t first, std::size_t count)
+        : cx(cx), cy(cy), cz(cz), half(half), first(first), count(count) {}
+
+    double cx, cy, cz, half;
+    std::size_t first, count;
+    double mass = 0, mx = 0, my = 0, mz = 0; // total mass and centre of mass
+    std::array<std::unique_ptr<bh_node>, 8> child;
+    bool split = false;
+};
+
+struct bh_tree {
+    explicit bh_tree(const particles& p) : order(p.size()) {
+        std::iota(order.begin(), order.end(), 0);
+        double lo = 0, hi = 0;
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            lo = std::min({lo, p.x[i], p.y[i], p.z[i]});
+            hi = std::max({hi, p.x[i], p.y[i], p.z[i]});
+        }
+        const double half = (hi - lo) / 2 * 1.001 + 1e-12, mid = (hi + lo) / 2;
+        root = std::make_unique<bh_node>(mid, mid, mid, half, 0, p.size());
+        min_half = half * 1e-9;
+    }
+
+    std::vector<std::uint32_t> order;
+    std::unique_ptr<bh_node> root;
+    double min_half;
+};
+
+// Distributes a node's particles over its octants and creates the non-empty
+// children, unless it holds at most leaf_size particles (or coincident ones).
+inline void bh_split(bh_tree& tree, const particles& p, bh_node& node, std::size_t leaf_size) {
+    if (node.count <= leaf_size || node.half < tree.min_half) return;
+    auto octant = [&](std::uint32_t i) {
+        return (p.x[i] >= node.cx ? 1 : 0) | (p.y[i] >= node.cy ? 2 : 0) | (p.z[i] >= node.cz ? 4 : 0);
+    };
+    std::array<std::size_t, 9> start{};
+    std::uint32_t* items = tree.order.data() + node.first;
+    for (std::size_t k = 0; k < node.count; ++k) ++start[octant(items[k]) + 1];
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<std::uint32_t> sorted(node.count);
+    auto next = start;
+    for (std::size_t k = 0; k < node.count; ++k) sorted[next[octant(items[k])]++] = items[k];
+    std::copy(sorted.begin(), sorted.end(), items);
+
+    const double h = node.half / 2;
+    for (int o = 0; o < 8; ++o) {
+        if (start[o + 1] == start[o]) continue;
+        node.child[o] = std::make_unique<bh_node>(node.cx + (o & 1 ? h : -h), node.cy + (o & 2 ? h : -h), node.cz + (o & 4 ? h : -h), h,
+                                                  node.first + start[o], start[o + 1] - start[o]);
+    }
+    node.split = true;
+}
+
+// Mass and centre of mass of a node, from its children if it has been split.
+inline void bh_summarize(const bh_tree& tree, const particles& p, bh_node& node) {
+    double mass = 0, mx = 0, my = 0, mz = 0;
+    if (node.split) {
+        for (const auto& c : node.child) {
+            if (!c) continue;
+            mass += c->mass;
+            mx += c->mx * c->mass;
+            my += c->my * c->mass;
+            mz += c->mz * c->mass;
+        }
+    } else {
+        for (std::size_t k = node.first; k < node.first + node.count; ++k) {
+            const std::uint32_t i = tree.order[k];
+            mass += p.m[i];
+            mx += p.x[i] * p.m[i];
+            my += p.y[i] * p.m[i];
+            mz += p.z[i] * p.m[i];
+        }
+    }
+    node.mass = mass;
+    node.mx = mass > 0 ? mx / mass : node.cx;
+    node.my = mass > 0 ? my / mass : node.cy;
+    node.mz = mass > 0 ? mz / mass : node.cz;
+}
+
+inline void bh_build_serial(bh_tree& tree, const particles& p, bh_node& node, std::size_t leaf_size) {
+    bh_split(tree, p, node, leaf_size);
+    for (auto& c : node.child) {
+        if (c) bh_build_serial(tree, p, *c, leaf_size);
+    }
+    bh_summarize(tree, p, node);
+}
+
+// Acceleration of particle i by walking the tree from root: a node whose size over
+// distance is below theta acts as a point mass, leaves are summed directly.
+inline void bh_accel(const bh_tree& tree, particles& p, std::uint32_t i, double theta) {
+    const double xi = p.x[i], yi = p.y[i], zi = p.z[i], theta2 = theta * theta;
+    double ax = 0, ay = 0, az = 0;
+    auto add = [&](double x, double y, double z, double m) {
+        const double dx = x - xi, dy = y - yi, dz = z - zi;
+        const double r2 = dx * dx + dy * dy + dz * dz + nbody_softening2;
+        const double s = m / (r2 * std::sqrt(r2));
+        ax += dx * s;
+        ay += dy * s;
+        az += dz * s;
+    };
+    thread_local std::vector<const bh_node*> stack;
+    stack.assign(1, tree.root.get());
+    while (!stack.empty()) {
+        const bh_node* node = stack.back();
+        stack.pop_back();
+        const double dx = node->mx - xi, dy = node->my - yi, dz = node->mz - zi;
+        const double size = 2 * node->half;
+        if (size * size < theta2 * (dx * dx + dy * dy + dz * dz)) {
+            add(node->mx, node->my, node->mz, node->mass);
+        } else if (node->split) {
+            for (const auto& c : node->child) {
+                if (c) stack.push_back(c.get());
+            }
+        } else {
+            for (std::size_t k = node->first; k < node->first + node->count; ++k) {
+                const std::uint32_t j = tree.order[k];
+                add(p.x[j], p.y[j], p.z[j], p.m[j]);
+            }
+        }
+    }
+    p.ax[i] = ax;
+    p.ay[i] = ay;
+    p.az[i] = az;
+}
+
+// Accelerations of every particle under node; neighbouring particles in tree
+// order walk similar paths, so a task's traversals share cached nodes.
+inline void bh_accel_node(const bh_tree& tree, particles& p, const bh_node& node, double theta) {
+    for (std::size_t k = node.first; k < node.first + node.count; ++k) bh_accel(tree, p, tree.order[k], theta);
+}
+
+#endif // NBODY_HPP
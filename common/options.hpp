@@ -0,0 +1,63 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+// Command line split into positional arguments and --name=value / --flag options.
+class options {
+public:
+    options(int argc, char* argv[]) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) {
+                positional_args.push_back(arg);
+                continue;
+            }
+            auto eq = arg.find('=');
+            if (eq == std::string::npos) {
+                named[arg.substr(2)] = "";
+            } else {
+                named[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+            }
+        }
+    }
+
+    const std::vector<std::string>& positional() const noexcept { return positional_args; }
+
+    std::string positional(std::size_t i, const std::string& fallback) const {
+        return i < positional_args.size() ? positional_args[i] : fallback;
+    }
+
+    bool has(const std::string& name) const { return named.count(name) != 0; }
+
+    std::string get(const std::string& name, const std::string& fallback) const {
+        auto it = named.find(name);
+        return it != named.end() ? it->second : fallback;
+    }
+
+    long get(const std::string& name, long fallback) const {
+        auto it = named.find(name);
+        return it != named.end() ? std::stol(it->second) : fallback;
+    }
+
+    // Comma-separated list of integers, e.g. "10,100,1000".
+    static std::vector<long> parse_list(const std::string& text) {
+        std::vector<long> values;
+        std::size_t start = 0;
+        while (start <= text.size()) {
+            std::size_t comma = std::min(text.find(',', start), text.size());
+            if (comma > start) values.push_back(std::stol(text.substr(start, comma - start)));
+            start = comma + 1;
+        }
+        return values;
+    }
+
+private:
+    std::vector<std::string> positional_args;
+    std::map<std::string, std::string> named;
+};
+
+#endif // OPTIONS_HPP
@@ -0,0 +1,41 @@
+#ifndef RUNTIME_STATS_HPP
+#define RUNTIME_STATS_HPP
+
+#include <cmath>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Scheduler statistics for the compute phase, in the fields both runtimes can fill:
+//   threads              worker threads
+//   tasks                tasks (HPX threads) run
+//   steals               tasks a worker took from another worker's queue
+//   elapsed_s            wall time the counters cover
+//   idle_rate            fraction of worker time spent without a task, 0..1
+//   average_overhead_ns  worker time not spent in tasks, per task
+// A value a runtime cannot report is NaN and printed as null.
+using runtime_stats = std::vector<std::pair<std::string, double>>;
+
+// Prints `tag: {"runtime": "...", "name": value, ...}` on one line; benchmark.py
+// picks these lines out of the program's output.
+inline void print_record(std::ostream& os, const std::string& tag, const std::string& runtime, const runtime_stats& fields) {
+    const auto precision = os.precision(15);
+    os << tag << ": {\"runtime\": \"" << runtime << "\"";
+    for (const auto& [name, value] : fields) {
+        os << ", \"" << name << "\": ";
+        if (std::isfinite(value)) {
+            os << value;
+        } else {
+            os << "null";
+        }
+    }
+    os << "}\n";
+    os.precision(precision);
+}
+
+inline void print_runtime_stats(std::ostream& os, const std::string& runtime, const runtime_stats& stats) {
+    print_record(os, "stats", runtime, stats);
+}
+
+#endif // RUNTIME_STATS_HPP
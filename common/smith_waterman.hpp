@@ -0,0 +1,102 @@
+#ifndef SMITH_WATERMAN_HPP
+#define SMITH_WATERMAN_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Smith-Waterman local alignment score of two DNA sequences with linear gap
+// penalties. Cell (i, j) needs its north, west and north-west neighbours, so the
+// matrix is cut into tiles computed as a wavefront: a tile can start once the
+// tiles north and west of it are done. The full matrix is never stored; each
+// tile reads the row above it and the column to its left from the edges its
+// neighbours wrote, and writes its own last row and column.
+
+constexpr int sw_match = 2, sw_mismatch = -1, sw_gap = -2;
+
+inline std::string random_dna(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> base(0, 3);
+    std::string s(n, 'A');
+    for (auto& c : s) c = "ACGT"[base(rng)];
+    return s;
+}
+
+// A copy of s with about `rate` of its positions substituted, so the two
+// sequences align well and scores are far above those of unrelated sequences.
+inline std::string mutate_dna(const std::string& s, double rate, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::bernoulli_distribution change(rate);
+    std::uniform_int_distribution<int> base(0, 3);
+    std::string t = s;
+    for (auto& c : t) {
+        if (change(rng)) c = "ACGT"[base(rng)];
+    }
+    return t;
+}
+
+// Reference: the whole matrix row by row.
+inline int sw_serial(const std::string& a, const std::string& b) {
+    std::vector<int> prev(b.size() + 1, 0), cur(b.size() + 1, 0);
+    int best = 0;
+    for (std::size_t i = 1; i <= a.size(); ++i) {
+        for (std::size_t j = 1; j <= b.size(); ++j) {
+            const int diagonal = prev[j - 1] + (a[i - 1] == b[j - 1] ? sw_match : sw_mismatch);
+            cur[j] = std::max({0, diagonal, prev[j] + sw_gap, cur[j - 1] + sw_gap});
+            best = std::max(best, cur[j]);
+        }
+        std::swap(prev, cur);
+    }
+    return best;
+}
+
+// Tiles of the (a.size() + 1) x (b.size() + 1) score matrix, row 0 and column 0
+// being the zero border. rows[r] holds matrix row (r + 1) * tile for every
+// column, each tile filling its own columns; cols[c] likewise holds matrix
+// column (c + 1) * tile. Tiles are numbered row-major, t = r * tile_cols + c.
+struct sw_tiles {
+    sw_tiles(const std::string& a, const std::string& b, std::size_t tile)
+        : a(a), b(b), tile(tile), tile_rows((a.size() + tile - 1) / tile), tile_cols((b.size() + tile - 1) / tile),
+          rows(tile_rows, std::vector<int>(b.size() + 1, 0)), cols(tile_cols, std::vector<int>(a.size() + 1, 0)),
+          best(tile_rows * tile_cols, 0) {}
+
+    std::size_t count() const noexcept { return tile_rows * tile_cols; }
+
+    // Scores one tile from its north and west edges and records its best cell.
+    void run(std::size_t t) {
+        const std::size_t r = t / tile_cols, c = t % tile_cols;
+        const std::size_t i0 = r * tile, i1 = std::min(a.size(), i0 + tile);
+        const std::size_t j0 = c * tile, j1 = std::min(b.size(), j0 + tile), width = j1 - j0;
+        // prev[k] and cur[k] are columns j0 + k of the previous and current row.
+        std::vector<int> prev(width + 1, 0), cur(width + 1, 0);
+        if (r > 0) std::copy(rows[r - 1].begin() + j0, rows[r - 1].begin() + j1 + 1, prev.begin());
+        const std::vector<int>* west = c > 0 ? &cols[c - 1] : nullptr;
+        int top = 0;
+        for (std::size_t i = i0 + 1; i <= i1; ++i) {
+            cur[0] = west ? (*west)[i] : 0;
+            const char ai = a[i - 1];
+            for (std::size_t k = 1; k <= width; ++k) {
+                const int diagonal = prev[k - 1] + (ai == b[j0 + k - 1] ? sw_match : sw_mismatch);
+                cur[k] = std::max({0, diagonal, prev[k] + sw_gap, cur[k - 1] + sw_gap});
+                top = std::max(top, cur[k]);
+            }
+            cols[c][i] = cur[width];
+            std::swap(prev, cur);
+        }
+        std::copy(prev.begin() + 1, prev.end(), rows[r].begin() + j0 + 1);
+        best[t] = top;
+    }
+
+    int score() const { return *std::max_element(best.begin(), best.end()); }
+
+    const std::string& a;
+    const std::string& b;
+    std::size_t tile, tile_rows, tile_cols;
+    std::vector<std::vector<int>> rows, cols;
+    std::vector<int> best;
+};
+
+#endif // SMITH_WATERMAN_HPP
@@ -0,0 +1,175 @@
+#ifndef SPARSE_HPP
+#define SPARSE_HPP
+
+#include "matrix.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Compressed sparse row matrix: the non-zeros of row i are
+// values[row_ptr[i] .. row_ptr[i + 1]) in columns col_idx[...], sorted by column.
+template <class T>
+struct csr_matrix {
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::vector<std::size_t> row_ptr;
+    std::vector<std::uint32_t> col_idx;
+    std::vector<T> values;
+
+    std::size_t nnz() const noexcept { return values.size(); }
+};
+
+template <class T, class Rng>
+T random_value(Rng& rng) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::uniform_real_distribution<T>(-1, 1)(rng);
+    } else {
+        return static_cast<T>(std::uniform_int_distribution<int>(-3, 3)(rng));
+    }
+}
+
+// Row lengths follow a Zipf law, row i getting about c / (i + 1)^alpha non-zeros
+// with c chosen so the mean is avg_nnz, so the heaviest rows come first. alpha = 0
+// gives uniform rows. Columns are drawn uniformly; duplicates are dropped.
+template <class T>
+csr_matrix<T> power_law_matrix(std::size_t rows, std::size_t cols, double avg_nnz, double alpha, std::uint64_t seed) {
+    std::vector<double> weight(rows);
+    double total = 0;
+    for (std::size_t i = 0; i < rows; ++i) {
+        weight[i] = std::pow(static_cast<double>(i + 1), -alpha);
+        total += weight[i];
+    }
+
+    csr_matrix<T> A;
+    A.rows = rows;
+    A.cols = cols;
+    A.row_ptr.assign(1, 0);
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::uint32_t> column(0, static_cast<std::uint32_t>(cols - 1));
+    std::vector<std::uint32_t> row;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const double expected = avg_nnz * rows * weight[i] / total;
+        std::size_t length = static_cast<std::size_t>(expected);
+        if (std::uniform_real_distribution<double>(0, 1)(rng) < expected - length) ++length;
+        length = std::min(length, cols);
+
+        row.resize(length);
+        for (auto& c : row) c = column(rng);
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+
+        A.col_idx.insert(A.col_idx.end(), row.begin(), row.end());
+        for (std::size_t k = 0; k < row.size(); ++k) A.values.push_back(random_value<T>(rng));
+        A.row_ptr.push_back(A.col_idx.size());
+    }
+    return A;
+}
+
+enum class sparse_partition { rows, merge };
+
+// Where a partition starts: the first row it touches and the first non-zero it owns.
+struct merge_coord {
+    std::size_t row;
+    std::size_t nz;
+};
+
+// Boundaries of `parts` partitions. Row blocks give each partition the same number
+// of rows. Merge path (Merrill and Garland, SC'16) splits the merged sequence of
+// row ends and non-zeros evenly, so every partition does the same work and long
+// rows are cut between partitions.
+template <class T>
+std::vector<merge_coord> partition_bounds(const csr_matrix<T>& A, sparse_partition kind, std::size_t parts) {
+    std::vector<merge_coord> bounds(parts + 1);
+    const std::size_t total = A.rows + A.nnz();
+    for (std::size_t p = 0; p <= parts; ++p) {
+        if (kind == sparse_partition::rows) {
+            const std::size_t row = A.rows * p / parts;
+            bounds[p] = {row, A.row_ptr[row]};
+            continue;
+        }
+        const std::size_t diagonal = total * p / parts;
+        std::size_t lo = diagonal > A.nnz() ? diagonal - A.nnz() : 0;
+        std::size_t hi = std::min(diagonal, A.rows);
+        while (lo < hi) {
+            const std::size_t pivot = (lo + hi) / 2;
+            if (A.row_ptr[pivot + 1] <= diagonal - pivot - 1) lo = pivot + 1;
+            else hi = pivot;
+        }
+        bounds[p] = {lo, diagonal - lo};
+    }
+    return bounds;
+}
+
+// Largest partition's share of the non-zeros relative to the mean.
+inline double partition_imbalance(const std::vector<merge_coord>& bounds) {
+    const std::size_t parts = bounds.size() - 1;
+    std::size_t largest = 0;
+    for (std::size_t p = 0; p < parts; ++p) largest = std::max(largest, bounds[p + 1].nz - bounds[p].nz);
+    const double mean = static_cast<double>(bounds.back().nz) / parts;
+    return mean > 0 ? largest / mean : 1.0;
+}
+
+// y = A x. parallel_for(n, f) must call f(0) .. f(n - 1), possibly concurrently,
+// and return once all calls have finished. Each partition writes the rows it
+// finishes and keeps the partial sum of the row it stops inside; those carries
+// are added afterwards, in order.
+template <class T, class Acc, class ParallelFor>
+void spmv(const csr_matrix<T>& A, const std::vector<merge_coord>& bounds, const T* x, Acc* y, ParallelFor&& parallel_for) {
+    const std::size_t parts = bounds.size() - 1;
+    std::vector<Acc> carry(parts);
+    parallel_for(parts, [&](std::size_t p) {
+        std::size_t nz = bounds[p].nz;
+        const merge_coord end = bounds[p + 1];
+        for (std::size_t row = bounds[p].row; row < end.row; ++row) {
+            Acc sum = 0;
+            for (; nz < A.row_ptr[row + 1]; ++nz) {
+                sum += static_cast<Acc>(A.values[nz]) * static_cast<Acc>(x[A.col_idx[nz]]);
+            }
+            y[row] = sum;
+        }
+        Acc sum = 0;
+        for (; nz < end.nz; ++nz) {
+            sum += static_cast<Acc>(A.values[nz]) * static_cast<Acc>(x[A.col_idx[nz]]);
+        }
+        carry[p] = sum;
+    });
+    for (std::size_t p = 0; p < parts; ++p) {
+        if (bounds[p + 1].row < A.rows) y[bounds[p + 1].row] += carry[p];
+    }
+}
+
+// Y = A X for a dense X with X.rows == A.cols, partitioned as spmv. Carries are
+// whole rows of Y.
+template <class T, class Acc, class ParallelFor>
+void spmm(const csr_matrix<T>& A, const std::vector<merge_coord>& bounds, matrix_view<const T> X, matrix_view<Acc> Y, ParallelFor&& parallel_for) {
+    const std::size_t parts = bounds.size() - 1;
+    const std::size_t k = X.cols;
+    dense_matrix<Acc> carry(parts, k);
+    auto accumulate = [&](std::size_t nz, Acc* out) {
+        const Acc a = static_cast<Acc>(A.values[nz]);
+        const T* x = X.row(A.col_idx[nz]);
+        for (std::size_t j = 0; j < k; ++j) out[j] += a * static_cast<Acc>(x[j]);
+    };
+    parallel_for(parts, [&](std::size_t p) {
+        std::size_t nz = bounds[p].nz;
+        const merge_coord end = bounds[p + 1];
+        for (std::size_t row = bounds[p].row; row < end.row; ++row) {
+            Acc* out = Y.row(row);
+            std::fill_n(out, k, Acc{});
+            for (; nz < A.row_ptr[row + 1]; ++nz) accumulate(nz, out);
+        }
+        Acc* out = carry.view().row(p);
+        for (; nz < end.nz; ++nz) accumulate(nz, out);
+    });
+    for (std::size_t p = 0; p < parts; ++p) {
+        if (bounds[p + 1].row >= A.rows) continue;
+        Acc* out = Y.row(bounds[p + 1].row);
+        for (std::size_t j = 0; j < k; ++j) out[j] += carry(p, j);
+    }
+}
+
+#endif // SPARSE_HPP
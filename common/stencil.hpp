@@ -0,0 +1,132 @@
+#ifndef STENCIL_HPP
+#define STENCIL_HPP
+
+#include "matrix.hpp"
+#include "block_grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Explicit 2D heat diffusion (Jacobi, 5-point stencil) on an n x n grid whose
+// outer ring is a fixed boundary: the top edge is held at 1, the rest at 0. The
+// grid is split into block_grid tiles. A task advances one tile by `steps`
+// timesteps from one buffer into the other, so buffers alternate per task step.
+constexpr double heat_alpha = 0.2;
+
+inline double heat_update(double c, double north, double south, double west, double east) {
+    return c + heat_alpha * (north + south + west + east - 4 * c);
+}
+
+struct heat_grid {
+    heat_grid(std::size_t n, std::size_t tile) : n(n), tiles{n, n, tile, tile}, buffers{dense_matrix<double>(n, n), dense_matrix<double>(n, n)} {
+        for (auto& u : buffers) std::fill_n(&u(0, 0), n, 1.0);
+    }
+
+    // Sets the interior back to 0 in both buffers.
+    void reset() {
+        for (auto& u : buffers) {
+            for (std::size_t i = 1; i + 1 < n; ++i) std::fill_n(&u(i, 1), n - 2, 0.0);
+        }
+    }
+
+    bool interior(std::size_t i, std::size_t j) const noexcept { return i > 0 && j > 0 && i + 1 < n && j + 1 < n; }
+
+    // Tiles whose steps-step update reads tile b's cells: the 4 edge neighbours for
+    // a single step, plus the diagonal ones when the halo spans several steps.
+    std::vector<std::size_t> neighbours(std::size_t b, std::size_t steps) const {
+        const long down = static_cast<long>(tiles.blocks_down()), across = static_cast<long>(tiles.blocks_across());
+        const long r = static_cast<long>(b / tiles.blocks_across()), c = static_cast<long>(b % tiles.blocks_across());
+        std::vector<std::size_t> result;
+        for (long dr = -1; dr <= 1; ++dr) {
+            for (long dc = -1; dc <= 1; ++dc) {
+                if ((dr == 0 && dc == 0) || (steps == 1 && dr != 0 && dc != 0)) continue;
+                if (r + dr < 0 || r + dr >= down || c + dc < 0 || c + dc >= across) continue;
+                result.push_back(static_cast<std::size_t>((r + dr) * across + c + dc));
+            }
+        }
+        return result;
+    }
+
+    std::size_t n;
+    block_grid tiles;
+    dense_matrix<double> buffers[2];
+};
+
+// Advances tile b from src by `steps` timesteps and writes it to dst. With more
+// than one step the tile plus a halo of `steps` cells is copied to per-thread
+// scratch and the intermediate steps run there, each on a region one cell smaller
+// (overlapped temporal blocking), so only the final step touches dst. The halo
+// must not reach past the neighbouring tiles: steps <= tile size.
+inline void heat_advance(const heat_grid& g, std::size_t b, matrix_view<const double> src, matrix_view<double> dst, std::size_t steps) {
+    const auto t = g.tiles[b];
+    if (steps == 1) {
+        for (std::size_t i = t.r0; i < t.r1; ++i) {
+            for (std::size_t j = t.c0; j < t.c1; ++j) {
+                dst(i, j) = g.interior(i, j) ? heat_update(src(i, j), src(i - 1, j), src(i + 1, j), src(i, j - 1), src(i, j + 1)) : src(i, j);
+            }
+        }
+        return;
+    }
+
+    // Region of the grid held at step s (0 <= s < steps): the tile grown by
+    // steps - s cells and clipped to the grid. Scratch is indexed relative to step 0's.
+    auto grow = [&](std::size_t lo, std::size_t hi, std::size_t by) {
+        return std::pair{lo > by ? lo - by : 0, std::min(g.n, hi + by)};
+    };
+    const auto [i0, i1] = grow(t.r0, t.r1, steps);
+    const auto [j0, j1] = grow(t.c0, t.c1, steps);
+    const std::size_t width = j1 - j0, cells = (i1 - i0) * width;
+    thread_local std::vector<double> scratch[2];
+    for (auto& s : scratch) s.resize(std::max(s.size(), cells));
+    matrix_view<double> from{scratch[0].data(), i1 - i0, width, width};
+    matrix_view<double> to{scratch[1].data(), i1 - i0, width, width};
+
+    for (std::size_t i = i0; i < i1; ++i) std::copy(src.row(i) + j0, src.row(i) + j1, from.row(i - i0));
+    for (std::size_t s = 1; s <= steps; ++s) {
+        const auto [ri0, ri1] = grow(t.r0, t.r1, steps - s);
+        const auto [rj0, rj1] = grow(t.c0, t.c1, steps - s);
+        for (std::size_t i = ri0; i < ri1; ++i) {
+            for (std::size_t j = rj0; j < rj1; ++j) {
+                const std::size_t li = i - i0, lj = j - j0;
+                const double v = g.interior(i, j)
+                    ? heat_update(from(li, lj), from(li - 1, lj), from(li + 1, lj), from(li, lj - 1), from(li, lj + 1))
+                    : from(li, lj);
+                if (s == steps) {
+                    dst(i, j) = v;
+                } else {
+                    to(li, lj) = v;
+                }
+            }
+        }
+        std::swap(from, to);
+    }
+}
+
+// Steps per task step for `steps` timesteps in blocks of `block`: block, ..., block, remainder.
+inline std::vector<std::size_t> heat_plan(std::size_t steps, std::size_t block) {
+    std::vector<std::size_t> plan;
+    for (std::size_t done = 0; done < steps; done += block) plan.push_back(std::min(block, steps - done));
+    return plan;
+}
+
+// Step count whose neighbours(t, ...) are the tiles task step b of tile t waits
+// for besides t itself: those it reads, which step b - 1 wrote, and those whose
+// step b - 1 update read t's cells from the buffer step b overwrites. Each set is
+// symmetric for a given step count, so it is also the set of step-b tasks a
+// finished step b - 1 task releases.
+inline std::size_t heat_reach(const std::vector<std::size_t>& plan, std::size_t b) {
+    return b > 0 ? std::max(plan[b], plan[b - 1]) : plan[b];
+}
+
+// The largest difference between two grids, for --check.
+inline double heat_max_diff(matrix_view<const double> a, matrix_view<const double> b) {
+    double diff = 0;
+    for (std::size_t i = 0; i < a.rows; ++i) {
+        for (std::size_t j = 0; j < a.cols; ++j) diff = std::max(diff, std::abs(a(i, j) - b(i, j)));
+    }
+    return diff;
+}
+
+#endif // STENCIL_HPP
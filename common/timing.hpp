@@ -0,0 +1,13 @@
+#ifndef TIMING_HPP
+#define TIMING_HPP
+
+#include <chrono>
+
+// Clock and millisecond helper for the programs that time phases separately.
+using clock_type = std::chrono::steady_clock;
+
+inline double ms_between(clock_type::time_point a, clock_type::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+#endif // TIMING_HPP
@@ -0,0 +1,133 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/runtime.hpp>
+#include "worker_slots.hpp"
+#include "aggregate.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Histogram of n Zipf-distributed keys into --buckets buckets, and group-by of
+// the same records into --groups keys (count and sum per key). Records are
+// processed in --chunk sized loop iterations, either into one table per HPX
+// worker thread merged at the end ("private") or into one atomic table
+// ("shared"); "auto" picks by table size. Every strategy is checked against a
+// serial run.
+
+std::vector<std::uint64_t> histogram_private(const aggregate_input& in, std::size_t buckets, std::size_t chunk) {
+    worker_slots<std::vector<std::uint64_t>> tables{std::vector<std::uint64_t>(buckets)};
+    for_each_chunk(in.keys.size(), chunk, [&](std::size_t begin, std::size_t end) { histogram_add(tables.local(), in, begin, end); });
+    // Merge by bucket ranges so each iteration reads one range of every worker's table.
+    std::vector<std::uint64_t> counts(buckets);
+    constexpr std::size_t range = 4096;
+    hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), (buckets + range - 1) / range, [&](std::size_t r) {
+        const std::size_t end = std::min(buckets, (r + 1) * range);
+        std::as_const(tables).for_each([&](const std::vector<std::uint64_t>& t) {
+            for (std::size_t b = r * range; b < end; ++b) counts[b] += t[b];
+        });
+    });
+    return counts;
+}
+
+std::vector<std::uint64_t> histogram_shared(const aggregate_input& in, std::size_t buckets, std::size_t chunk) {
+    std::vector<std::atomic<std::uint64_t>> shared(buckets);
+    for_each_chunk(in.keys.size(), chunk, [&](std::size_t begin, std::size_t end) { histogram_add(shared, in, begin, end); });
+    std::vector<std::uint64_t> counts(buckets);
+    for (std::size_t b = 0; b < buckets; ++b) counts[b] = shared[b].load(std::memory_order_relaxed);
+    return counts;
+}
+
+group_table group_by_private(const aggregate_input& in, std::size_t groups, std::size_t chunk) {
+    worker_slots<group_table> tables{group_table(groups)};
+    for_each_chunk(in.keys.size(), chunk, [&](std::size_t begin, std::size_t end) { tables.local().add(in, begin, end); });
+    return tables.combine(group_table(groups), [](group_table acc, const group_table& t) {
+        acc.merge(t);
+        return acc;
+    });
+}
+
+shared_group_table group_by_shared(const aggregate_input& in, std::size_t groups, std::size_t chunk) {
+    shared_group_table table(groups);
+    for_each_chunk(in.keys.size(), chunk, [&](std::size_t begin, std::size_t end) { table.add(in, begin, end); });
+    return table;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "10000000"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::size_t buckets = std::max(1L, opts.get("buckets", 256L));
+    const std::size_t groups = std::max(1L, opts.get("groups", 100000L));
+    const double skew = std::stod(opts.get("skew", std::string("1.0")));
+    const std::size_t chunk = std::max(1L, opts.get("chunk", 16384L));
+    const std::string strategy = opts.get("strategy", std::string("all"));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "histogram" && mode != "group-by" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected histogram, group-by or all)\n";
+        return 1;
+    }
+    if (strategy != "private" && strategy != "shared" && strategy != "auto" && strategy != "all") {
+        std::cerr << "Unknown strategy: " << strategy << " (expected private, shared, auto or all)\n";
+        return 1;
+    }
+
+    const auto in = zipf_records(n, groups, skew, opts.get("seed", 1L));
+    std::cout << n << " records, " << groups << " keys, skew " << skew << "\n";
+
+    for (const char* kernel : {"histogram", "group-by"}) {
+        if (mode != "all" && mode != kernel) continue;
+        const bool histogram = std::string(kernel) == "histogram";
+
+        std::vector<std::uint64_t> expected;
+        std::size_t table_bytes;
+        if (histogram) {
+            expected.assign(buckets, 0);
+            histogram_add(expected, in, 0, n);
+            table_bytes = buckets * sizeof(std::uint64_t);
+        } else {
+            group_table serial(groups);
+            serial.add(in, 0, n);
+            expected = group_totals(serial, groups);
+            table_bytes = serial.bytes();
+        }
+        const std::string chosen = prefer_private(table_bytes) ? "private" : "shared";
+        std::cout << kernel << ": " << table_bytes / 1024 << " KiB table, auto picks " << chosen << "\n";
+
+        for (const char* name : {"private", "shared"}) {
+            if (strategy != "all" && strategy != name && !(strategy == "auto" && chosen == name)) continue;
+            const bool priv = std::string(name) == "private";
+
+            double best = 0;
+            std::vector<std::uint64_t> result;
+            for (long r = 0; r < reps; ++r) {
+                auto start = std::chrono::steady_clock::now();
+                std::chrono::duration<double> elapsed;
+                if (histogram) {
+                    result = priv ? histogram_private(in, buckets, chunk) : histogram_shared(in, buckets, chunk);
+                    elapsed = std::chrono::steady_clock::now() - start;
+                } else if (priv) {
+                    const auto table = group_by_private(in, groups, chunk);
+                    elapsed = std::chrono::steady_clock::now() - start;
+                    result = group_totals(table, groups);
+                } else {
+                    const auto table = group_by_shared(in, groups, chunk);
+                    elapsed = std::chrono::steady_clock::now() - start;
+                    result = group_totals(table, groups);
+                }
+                best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+            }
+            std::cout << kernel << " " << name << ": " << best * 1e3 << " ms (best of " << reps << "), " << n / best * 1e-6
+                      << " Mrecords/s, " << (result == expected ? "matches serial" : "MISMATCH") << "\n";
+        }
+    }
+    return 0;
+}
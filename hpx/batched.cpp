@@ -0,0 +1,105 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/future.hpp>
+#include "gemm_batched.hpp"
+#include "options.hpp"
+#include "element_types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Batched small GEMM: `count` independent n x n products submitted as one task per
+// matrix, one task per group of --batch matrices, or a parallel for_loop over all
+// matrices. The work per task is tiny, so throughput measures scheduling overhead.
+
+template <std::size_t N, class T, class Acc>
+void run_batched(const std::string& mode, const gemm_batch<T, Acc>& batch, std::size_t group) {
+    if (mode == "task" || mode == "batch") {
+        const std::size_t size = mode == "task" ? 1 : group;
+        const std::size_t tasks = (batch.count + size - 1) / size;
+        std::vector<hpx::future<void>> futures;
+        futures.reserve(tasks);
+        for (std::size_t t = 0; t < tasks; ++t) {
+            futures.push_back(hpx::async([&batch, size, t]() {
+                multiply_batch_range<N>(batch, t * size, std::min(batch.count, (t + 1) * size));
+            }));
+        }
+        hpx::wait_all(futures);
+    } else {
+        hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), batch.count, [&batch](std::size_t i) {
+            multiply_batch_range<N>(batch, i, i + 1);
+        });
+    }
+}
+
+template <class T>
+int run_benchmark(const std::string& mode, std::size_t count, const options& opts) {
+    using Acc = accumulator_t<T>;
+    const std::size_t n = std::max(1L, opts.get("n", 16L));
+    const std::size_t group = std::max(1L, opts.get("batch", 64L));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "task" && mode != "batch" && mode != "bulk" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected task, batch, bulk or all)\n";
+        return 1;
+    }
+
+    gemm_batch<T, Acc> batch(count, n);
+    fill_batch(batch, opts.get("seed", 1L));
+
+    // Serial results for a sample of matrices, to check every mode against.
+    const std::size_t sample_step = std::max<std::size_t>(1, count / 64);
+    gemm_batch<T, Acc> expected(1, n);
+    auto check = [&]() {
+        double error = 0;
+        for (std::size_t i = 0; i < count; i += sample_step) {
+            small_gemm<0>(batch.a_matrix(i), batch.b_matrix(i), expected.c_matrix(0), n);
+            for (std::size_t e = 0; e < n * n; ++e) {
+                error = std::max(error, std::abs(static_cast<double>(batch.c_matrix(i)[e]) - static_cast<double>(expected.c_matrix(0)[e])));
+            }
+        }
+        return error;
+    };
+
+    const double flops = 2.0 * n * n * n * count;
+    for (const char* name : {"task", "batch", "bulk"}) {
+        if (mode != "all" && mode != name) continue;
+
+        std::fill_n(batch.c.data(), count * n * n, Acc{});
+        double best = 0;
+        for (long r = 0; r < reps; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            dispatch_small_size(n, [&](auto size) {
+                run_batched<decltype(size)::value>(name, batch, group);
+            });
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        std::cout << name << ": " << count << " x " << n << "x" << n << " in " << best * 1e3 << " ms (best of " << reps
+                  << "), " << count / best << " matrices/s, " << flops / best * 1e-9 << " GFLOP/s, max error " << check() << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long count = std::stol(opts.positional(0, "100000"));
+    if (count <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    std::string type = opts.get("type", std::string("float"));
+
+    int status = 1;
+    bool known = dispatch_element_type(type, [&](auto tag) {
+        status = run_benchmark<typename decltype(tag)::type>(mode, count, opts);
+    });
+    if (!known) {
+        std::cerr << "Unknown element type: " << type << " (expected int32, int16, int8, float or double)\n";
+        return 1;
+    }
+
+    return status;
+}
@@ -0,0 +1,101 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/runtime.hpp>
+#include "worker_slots.hpp"
+#include "graph.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Breadth-first search over an R-MAT graph of 2^scale vertices or a --graph edge
+// list, from --roots random roots. Each level is one parallel for_loop over
+// --grain sized blocks of the frontier (or, bottom-up, of all vertices), and
+// newly reached vertices go to worker_slots next-frontier buffers.
+// Reports the Graph500 harmonic-mean TEPS and checks every tree against a serial BFS.
+
+struct hpx_runtime {
+    template <class F>
+    void for_blocks(std::size_t count, F&& f) {
+        hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), count, f);
+    }
+
+    std::vector<std::uint32_t>& local() { return buffers.local(); }
+
+    void gather(std::vector<std::uint32_t>& out) {
+        buffers.for_each([&out](std::vector<std::uint32_t>& b) {
+            out.insert(out.end(), b.begin(), b.end());
+            b.clear();
+        });
+    }
+
+    worker_slots<std::vector<std::uint32_t>> buffers;
+};
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    const std::string mode = opts.positional(1, "all");
+    const std::size_t grain = std::max(1L, opts.get("grain", 256L));
+    const long roots = std::max(1L, opts.get("roots", 8L));
+
+    if (mode != "top-down" && mode != "direction-optimising" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected top-down, direction-optimising or all)\n";
+        return 1;
+    }
+
+    csr_graph g;
+    if (opts.has("graph")) {
+        g = load_edge_list(opts.get("graph", std::string()));
+    } else {
+        const long scale = std::stol(opts.positional(0, "18"));
+        if (scale <= 0 || scale > 31) return 1;
+        g = rmat_graph(scale, std::max(1L, opts.get("edge-factor", 16L)), opts.get("seed", 1L));
+    }
+    std::cout << g.vertices() << " vertices, " << g.col.size() / 2 << " undirected edges\n";
+
+    std::vector<std::uint32_t> sources;
+    std::mt19937_64 rng(opts.get("seed", 1L) + 1);
+    std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(g.vertices() - 1));
+    for (std::size_t tries = 0; sources.size() < static_cast<std::size_t>(roots) && tries < 100 * g.vertices(); ++tries) {
+        const std::uint32_t v = pick(rng);
+        if (g.degree(v) > 0) sources.push_back(v);
+    }
+    if (sources.empty()) {
+        std::cerr << "Graph has no edges\n";
+        return 1;
+    }
+
+    hpx_runtime rt;
+    bfs_state s(g.vertices());
+    std::vector<std::vector<std::uint32_t>> expected;
+    for (std::uint32_t root : sources) expected.push_back(bfs_serial_depths(g, root));
+
+    for (const char* name : {"top-down", "direction-optimising"}) {
+        if (mode != "all" && mode != name) continue;
+        const bool direction_optimising = std::string(name) == "direction-optimising";
+
+        double total = 0, inverse_teps = 0;
+        std::size_t levels = 0, bottom_up = 0, invalid = 0;
+        for (std::size_t r = 0; r < sources.size(); ++r) {
+            std::size_t steps = 0;
+            auto start = std::chrono::steady_clock::now();
+            levels += bfs_run(rt, g, s, sources[r], direction_optimising, grain, &steps);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            total += elapsed.count();
+            inverse_teps += elapsed.count() / static_cast<double>(bfs_traversed_edges(g, s));
+            bottom_up += steps;
+            if (!bfs_valid(g, s, sources[r], expected[r])) ++invalid;
+        }
+        std::cout << name << ": " << total / sources.size() * 1e3 << " ms per search, "
+                  << sources.size() / inverse_teps * 1e-6 << " MTEPS (harmonic mean over " << sources.size() << " roots), "
+                  << static_cast<double>(levels) / sources.size() << " levels";
+        if (direction_optimising) std::cout << " (" << static_cast<double>(bottom_up) / sources.size() << " bottom-up)";
+        std::cout << ", " << (invalid == 0 ? "valid" : std::to_string(invalid) + " INVALID") << "\n";
+    }
+    return 0;
+}
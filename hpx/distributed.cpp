@@ -0,0 +1,92 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/hpx.hpp>
+#include <hpx/serialization/vector.hpp>
+#include "matrix.hpp"
+#include "gemm_pipeline.hpp"
+#include "gemm_recursive.hpp"
+#include "options.hpp"
+#include "element_types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// Distributed run of C = weighted(A) * B across all localities. Locality 0 builds
+// A and B, sends each locality a contiguous range of A's rows plus all of B
+// through an action, and gathers the C rows back. Each locality multiplies its
+// rows with a parallel for_loop over first_touch_rows blocks. The same product
+// computed on locality 0 alone is timed for comparison.
+
+using element = double;
+
+// C rows = weighted(a_rows) * b, where a_rows holds rows x n and b holds n x n.
+std::vector<element> multiply_rows(std::size_t n, std::vector<element> const& a_rows, std::vector<element> const& b) {
+    const std::size_t rows = a_rows.size() / n;
+    std::vector<element> c(rows * n);
+    matrix_view<const element> A{a_rows.data(), rows, n, n};
+    matrix_view<const element> B{b.data(), n, n, n};
+    matrix_view<element> C{c.data(), rows, n, n};
+    const std::size_t blocks = (rows + first_touch_rows - 1) / first_touch_rows;
+    hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), blocks, [&](std::size_t blk) {
+        const std::size_t r0 = blk * first_touch_rows;
+        const std::size_t nr = std::min(rows, r0 + first_touch_rows) - r0;
+        gemm_base(A.block(r0, 0, nr, n), B, C.block(r0, 0, nr, n), [](element a) { return weighted(a); });
+    });
+    return c;
+}
+HPX_PLAIN_ACTION(multiply_rows, multiply_rows_action)
+
+std::vector<element> multiply_distributed(std::size_t n, const std::vector<element>& a, const std::vector<element>& b,
+                                          const std::vector<hpx::id_type>& localities) {
+    const std::size_t parts = localities.size();
+    std::vector<hpx::future<std::vector<element>>> futures;
+    futures.reserve(parts);
+    for (std::size_t p = 0; p < parts; ++p) {
+        const std::size_t r0 = n * p / parts, r1 = n * (p + 1) / parts;
+        std::vector<element> a_rows(a.begin() + r0 * n, a.begin() + r1 * n);
+        futures.push_back(hpx::async<multiply_rows_action>(localities[p], n, std::move(a_rows), b));
+    }
+    std::vector<element> c(n * n);
+    for (std::size_t p = 0; p < parts; ++p) {
+        auto rows = futures[p].get();
+        std::copy(rows.begin(), rows.end(), c.begin() + n * p / parts * n);
+    }
+    return c;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "1024"));
+    if (n <= 0) return 1;
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    std::vector<element> a(n * n), b(n * n);
+    for (long i = 0; i < n; ++i) {
+        for (long j = 0; j < n; ++j) {
+            a[i * n + j] = gemm_pipeline<element>::a_value(i, j);
+            b[i * n + j] = gemm_pipeline<element>::b_value(i, j);
+        }
+    }
+
+    const auto localities = hpx::find_all_localities();
+    const std::vector<hpx::id_type> here{hpx::find_here()};
+    const double expected = gemm_pipeline<element>::expected_total(n);
+    for (const auto* targets : {&localities, &here}) {
+        double best = 0;
+        std::vector<element> c;
+        for (long r = 0; r < reps; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            c = multiply_distributed(n, a, b, *targets);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        double checksum = 0;
+        for (element v : c) checksum += v;
+        std::cout << targets->size() << (targets->size() == 1 ? " locality: " : " localities: ") << best << " ms (best of "
+                  << reps << "), checksum " << checksum << ", relative error "
+                  << std::abs(checksum - expected) / std::max(1.0, std::abs(expected)) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/runtime.hpp>
+#include "worker_slots.hpp"
+#include "kmeans.hpp"
+#include "options.hpp"
+#include "timing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// k-means on n points in --d dimensions drawn around --k blobs, for up to
+// --iterations rounds or until at most --tol of the points change cluster. Each
+// round is one parallel for_loop assigning blocks of points into worker_slots
+// partial sums (assign), a merge of those partials (reduce) and the
+// centroid update (update); each phase is timed per round.
+
+struct kmeans_result {
+    std::size_t iterations = 0;
+    double inertia = 0;
+};
+
+// The same rounds on the calling thread, for --check.
+kmeans_result kmeans_serial(const point_set& p, std::vector<float> centroids, std::size_t k, std::size_t max_iterations, double tol) {
+    std::vector<std::uint32_t> labels(p.n, std::numeric_limits<std::uint32_t>::max());
+    kmeans_result result;
+    for (std::size_t it = 0; it < max_iterations; ++it) {
+        kmeans_partial total(k, p.d);
+        for (std::size_t b = 0; b < p.n; b += kmeans_block) kmeans_assign(p, centroids, k, b, std::min(p.n, b + kmeans_block), labels, total);
+        kmeans_update(total, centroids);
+        result = {it + 1, total.inertia};
+        if (total.changed <= tol * p.n) break;
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "1000000"));
+    if (n <= 0) return 1;
+    const std::size_t d = std::max(1L, opts.get("d", 16L));
+    const std::size_t k = std::max(1L, opts.get("k", 16L));
+    const std::size_t max_iterations = std::max(1L, opts.get("iterations", 30L));
+    const double tol = std::stod(opts.get("tol", std::string("1e-4")));
+
+    const point_set p = gaussian_blobs(n, d, k, opts.get("seed", 1L));
+    const std::vector<float> initial = initial_centroids(p, k, opts.get("seed", 1L) + 1);
+    std::cout << n << " points, " << d << " dimensions, " << k << " clusters\n";
+
+    std::vector<float> centroids = initial;
+    std::vector<std::uint32_t> labels(n, std::numeric_limits<std::uint32_t>::max());
+    worker_slots<kmeans_partial> partials{kmeans_partial(k, d)};
+    const std::size_t blocks = (n + kmeans_block - 1) / kmeans_block;
+    double assign_ms = 0, reduce_ms = 0, update_ms = 0;
+    kmeans_result result;
+    for (std::size_t it = 0; it < max_iterations; ++it) {
+        auto t0 = clock_type::now();
+        hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), blocks, [&](std::size_t b) {
+            kmeans_assign(p, centroids, k, b * kmeans_block, std::min<std::size_t>(n, (b + 1) * kmeans_block), labels, partials.local());
+        });
+        auto t1 = clock_type::now();
+        const kmeans_partial total = partials.combine(kmeans_partial(k, d), [](kmeans_partial acc, const kmeans_partial& part) {
+            acc.merge(part);
+            return acc;
+        });
+        partials.reset(kmeans_partial(k, d));
+        auto t2 = clock_type::now();
+        kmeans_update(total, centroids);
+        auto t3 = clock_type::now();
+
+        assign_ms += ms_between(t0, t1);
+        reduce_ms += ms_between(t1, t2);
+        update_ms += ms_between(t2, t3);
+        result = {it + 1, total.inertia};
+        std::cout << "iteration " << it << ": assign " << ms_between(t0, t1) << " ms, reduce " << ms_between(t1, t2)
+                  << " ms, update " << ms_between(t2, t3) << " ms, " << total.changed << " changed, inertia " << total.inertia << "\n";
+        if (total.changed <= tol * n) break;
+    }
+    const double rounds = static_cast<double>(result.iterations);
+    std::cout << result.iterations << " iterations, per iteration: assign " << assign_ms / rounds << " ms, reduce "
+              << reduce_ms / rounds << " ms, update " << update_ms / rounds << " ms, "
+              << static_cast<double>(n) * k * d * rounds / (assign_ms * 1e-3) * 1e-9 << " G distance terms/s\n";
+
+    if (opts.has("check")) {
+        const kmeans_result serial = kmeans_serial(p, initial, k, max_iterations, tol);
+        std::cout << "serial: " << serial.iterations << " iterations, relative inertia difference "
+                  << std::abs(result.inertia - serial.inertia) / std::max(1.0, serial.inertia) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/runtime.hpp>
+#include "worker_slots.hpp"
+#include "irregular.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Loops with uneven iteration costs, run as one parallel for_loop under each
+// chunking policy:
+//   blocks  - static_chunk_size of n / workers, one contiguous block per worker
+//   static  - static_chunk_size with HPX's default size
+//   dynamic - dynamic_chunk_size of --grain indices
+//   guided  - guided_chunk_size with a minimum of --grain indices
+//   auto    - auto_chunk_size
+// The workloads are the rows of an n x n Mandelbrot image ("mandelbrot") and n
+// indices of a spin kernel whose cost follows --pattern ("variable"). Each
+// policy reports its speedup over a serial loop and the load imbalance across
+// workers, measured in the kernels' work units.
+
+template <class F>
+bool with_chunking(const std::string& chunk, std::size_t n, std::size_t grain, F&& f) {
+    using namespace hpx::execution;
+    const std::size_t workers = hpx::get_num_worker_threads();
+    if (chunk == "blocks") f(par.with(static_chunk_size((n + workers - 1) / workers)));
+    else if (chunk == "static") f(par.with(static_chunk_size()));
+    else if (chunk == "dynamic") f(par.with(dynamic_chunk_size(grain)));
+    else if (chunk == "guided") f(par.with(guided_chunk_size(grain)));
+    else if (chunk == "auto") f(par.with(auto_chunk_size()));
+    else return false;
+    return true;
+}
+
+template <class Body>
+void compare_chunking(std::size_t n, std::size_t grain, long reps, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) body(i);
+    const double serial = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "serial: " << serial * 1e3 << " ms\n";
+
+    for (const char* chunk : {"blocks", "static", "dynamic", "guided", "auto"}) {
+        double best = 0, imbalance = 0;
+        for (long r = 0; r < reps; ++r) {
+            worker_slots<double> loads;
+            start = std::chrono::steady_clock::now();
+            with_chunking(chunk, n, grain, [&](auto policy) {
+                hpx::experimental::for_loop(policy, std::size_t(0), n, [&](std::size_t i) {
+                    loads.local() += static_cast<double>(body(i));
+                });
+            });
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (r == 0 || elapsed < best) {
+                best = elapsed;
+                std::vector<double> per_worker;
+                loads.for_each([&per_worker](double l) { per_worker.push_back(l); });
+                imbalance = load_imbalance(per_worker, hpx::get_num_worker_threads());
+            }
+        }
+        std::cout << chunk << ": " << best * 1e3 << " ms (best of " << reps << "), speedup " << serial / best << ", imbalance "
+                  << imbalance << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "1024"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::string pattern = opts.get("pattern", std::string("spike"));
+    const std::size_t grain = std::max(1L, opts.get("grain", 4L));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "mandelbrot" && mode != "variable" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected mandelbrot, variable or all)\n";
+        return 1;
+    }
+    if (!known_cost_pattern(pattern)) {
+        std::cerr << "Unknown pattern: " << pattern << " (expected uniform, linear, spike or random)\n";
+        return 1;
+    }
+
+    std::cout << hpx::get_num_worker_threads() << " workers\n";
+
+    if (mode != "variable") {
+        mandelbrot_image image(n, n, static_cast<std::uint32_t>(std::max(1L, opts.get("max-iter", 1000L))));
+        std::cout << "mandelbrot " << n << "x" << n << ", max " << image.max_iter << " iterations, one row per index\n";
+        compare_chunking(n, grain, reps, [&image](std::size_t y) { return image.row(y); });
+    }
+    if (mode != "mandelbrot") {
+        const auto units = cost_profile(pattern, n, static_cast<std::uint32_t>(std::clamp(opts.get("cost", 100000L), 1L, 1L << 24)),
+                                        opts.get("seed", 1L));
+        std::vector<double> out(n);
+        std::cout << "variable cost, " << n << " indices, " << pattern << " pattern\n";
+        compare_chunking(n, grain, reps, [&](std::size_t i) {
+            out[i] = spin(units[i], static_cast<double>(i));
+            return static_cast<std::uint64_t>(units[i]) + 1;
+        });
+    }
+    return 0;
+}
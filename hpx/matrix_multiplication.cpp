@@ -2,13 +2,41 @@
 #include <hpx/algorithm.hpp>
 #include <hpx/execution.hpp>
 #include <hpx/init.hpp>
+#include <hpx/future.hpp>
+#include <hpx/include/performance_counters.hpp>
+#include "matrix.hpp"
+#include "gemm_packed.hpp"
+#include "gemm_recursive.hpp"
+#include "gemm_strassen.hpp"
+#include "options.hpp"
+#include "element_types.hpp"
+#include "matrix_file.hpp"
+#include "gemm_streaming.hpp"
+#include "first_touch.hpp"
+#include "block_grid.hpp"
+#include "runtime_stats.hpp"
+#include "cache_flush.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <iostream>
+#include <stdexcept>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 #include <cmath>
 
-using Matrix = std::vector<std::vector<int>>;
+template <class T>
+using Matrix = std::vector<std::vector<T>>;
 
-void print_matrix(const Matrix &M, const std::string &name, int max_rows = 5, int max_cols = 5) {
+// Set when sweeping several sizes or repetitions, where only the result records are printed.
+bool quiet = false;
+
+template <class T>
+void print_matrix(const Matrix<T> &M, const std::string &name, int max_rows = 5, int max_cols = 5) {
+    if (quiet) return;
     std::cout << "Matrix " << name << " (top-left " << max_rows << "x" << max_cols << " portion):\n";
     for (int i = 0; i < std::min(max_rows, static_cast<int>(M.size())); ++i) {
         for (int j = 0; j < std::min(max_cols, static_cast<int>(M[i].size())); ++j) {
@@ -18,12 +46,67 @@ void print_matrix(const Matrix &M, const std::string &name, int max_rows = 5, in
     }
 }
 
-void multiply_matrices(const Matrix &A, const Matrix &B, Matrix &C) {
+template <class T>
+void print_matrix(matrix_view<T> M, const std::string &name, int max_rows = 5, int max_cols = 5) {
+    if (quiet) return;
+    std::cout << "Matrix " << name << " (top-left " << max_rows << "x" << max_cols << " portion):\n";
+    for (std::size_t i = 0; i < std::min<std::size_t>(max_rows, M.rows); ++i) {
+        for (std::size_t j = 0; j < std::min<std::size_t>(max_cols, M.cols); ++j) {
+            std::cout << M(i, j) << "\t";
+        }
+        std::cout << "\n";
+    }
+}
+
+// Benchmark data is first written in parallel, in the row blocks the kernels later
+// compute on, so its pages are spread over the workers' NUMA nodes rather than all
+// on the main thread's; first_touch.hpp explains why this is only best effort.
+// --init=serial has the main thread write everything, as the original benchmark did.
+bool serial_init = false;
+
+auto init_loop() {
+    return [](std::size_t n, auto&& f) {
+        if (serial_init) {
+            for (std::size_t i = 0; i < n; ++i) f(i);
+        } else {
+            hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), n, f);
+        }
+    };
+}
+
+template <class T>
+dense_matrix<T> make_matrix(std::size_t rows, std::size_t cols, T value) {
+    dense_matrix<T> M(rows, cols, uninitialized);
+    first_touch_fill(M.view(), value, init_loop());
+    return M;
+}
+
+// Rows are allocated and filled in multiply_matrices' row blocks.
+template <class T>
+Matrix<T> make_row_matrix(int rows, int cols, T value) {
+    Matrix<T> M(rows);
+    int num_threads = std::thread::hardware_concurrency();
+    int block_size = rows / num_threads;
+    init_loop()(num_threads, [&](int t) {
+        int start_row = t * block_size;
+        int end_row = (t == num_threads - 1) ? rows : (t + 1) * block_size;
+        for (int i = start_row; i < end_row; ++i) {
+            M[i].assign(cols, value);
+        }
+    });
+    return M;
+}
+
+template <class T>
+void multiply_matrices(const Matrix<T> &A, const Matrix<T> &B, Matrix<result_t<T>> &C) {
+    using Acc = accumulator_t<T>;
+    using R = result_t<T>;
+
     int rowsA = A.size();
     int colsA = A[0].size();
     int colsB = B[0].size();
 
-    C.resize(rowsA, std::vector<int>(colsB, 0));
+    C.resize(rowsA, std::vector<R>(colsB, 0));
 
     int num_threads = std::thread::hardware_concurrency();
     int block_size = rowsA / num_threads;
@@ -33,29 +116,482 @@ void multiply_matrices(const Matrix &A, const Matrix &B, Matrix &C) {
         int end_row = (t == num_threads - 1) ? rowsA : (t + 1) * block_size;
         for (std::size_t i = start_row; i < end_row; ++i) {
             hpx::experimental::for_loop(0, colsB, [&](std::size_t j) {
-                double sum = 0.0; // Accumulate as double
+                Acc sum = 0; // Accumulate in the element type's accumulator
                 for (std::size_t k = 0; k < colsA; ++k) {
-                    double term = static_cast<double>(A[i][k]) * B[k][j] * std::sin(A[i][k]);
+                    Acc term = weighted(A[i][k]) * static_cast<Acc>(B[k][j]);
                     sum += term;
                 }
-                C[i][j] = static_cast<int>(sum); // Cast after accumulation
+                C[i][j] = static_cast<R>(sum); // Cast after accumulation
             });
         }
     });
 }
 
+// C[r0, r1) x [c0, c1) computed exactly as multiply_matrices does, so the chunked
+// kernel differs from it only in how the work is decomposed.
+template <class T>
+void multiply_block(const Matrix<T> &A, const Matrix<T> &B, Matrix<result_t<T>> &C, const block_grid::block& blk) {
+    using Acc = accumulator_t<T>;
+    using R = result_t<T>;
+    const std::size_t inner = B.size();
+    for (std::size_t i = blk.r0; i < blk.r1; ++i) {
+        for (std::size_t j = blk.c0; j < blk.c1; ++j) {
+            Acc sum = 0;
+            for (std::size_t k = 0; k < inner; ++k) {
+                sum += weighted(A[i][k]) * static_cast<Acc>(B[k][j]);
+            }
+            C[i][j] = static_cast<R>(sum);
+        }
+    }
+}
+
+// Parallelises over rows or tiles of C directly instead of one block per thread,
+// leaving how many items each HPX task runs to the policy's executor parameters.
+template <class T, class Policy>
+void multiply_matrices_chunked(const Matrix<T> &A, const Matrix<T> &B, Matrix<result_t<T>> &C, const block_grid& grid, Policy policy) {
+    hpx::experimental::for_loop(policy, std::size_t(0), grid.size(), [&](std::size_t b) {
+        multiply_block(A, B, C, grid[b]);
+    });
+}
+
+// Calls f with hpx::execution::par carrying the executor parameters named by
+// chunk ("none" for plain par). A size of 0 keeps the parameter's own default.
+// Returns false for unknown names.
+template <class F>
+bool with_chunking(const std::string& chunk, std::size_t size, F&& f) {
+    using namespace hpx::execution;
+    if (chunk == "none") f(par);
+    else if (chunk == "static") f(par.with(size ? static_chunk_size(size) : static_chunk_size()));
+    else if (chunk == "auto") f(par.with(auto_chunk_size()));
+    else if (chunk == "guided") f(par.with(size ? guided_chunk_size(size) : guided_chunk_size()));
+    else if (chunk == "dynamic") f(par.with(size ? dynamic_chunk_size(size) : dynamic_chunk_size()));
+    else return false;
+    return true;
+}
+
+// Converts acc into C, reusing C's storage when it already has acc's shape.
+template <class Acc, class R>
+void store_result(matrix_view<Acc> acc, dense_matrix<R> &C) {
+    if (C.rows() != acc.rows || C.cols() != acc.cols) C = dense_matrix<R>(acc.rows, acc.cols, uninitialized);
+    hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), C.rows(), [&](std::size_t i) {
+        for (std::size_t j = 0; j < C.cols(); ++j) {
+            C(i, j) = static_cast<R>(acc(i, j));
+        }
+    });
+}
+
+// Same product computed on contiguous storage with packed, unit-stride panels of A
+// and B, accumulated into acc, which must be zero.
+template <class T>
+void multiply_matrices_packed(matrix_view<const T> A, matrix_view<const T> B, matrix_view<accumulator_t<T>> acc, dense_matrix<result_t<T>> &C) {
+    gemm_packed(A, B, acc, weighted<T>, [](std::size_t n, auto&& f) {
+        hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), n, f);
+    });
+    store_result(acc, C);
+}
+
+// C += op(A) * B as a future-returning task tree. m- and n-halves run concurrently
+// (one via hpx::async, one inline) and are joined with dataflow; k-halves write the
+// same C, so the second is chained as a continuation of the first.
+template <class TA, class TB, class Acc, class Op>
+hpx::future<void> recursive_gemm(matrix_view<TA> A, matrix_view<TB> B, matrix_view<Acc> C, Op op) {
+    split_dim dim = choose_split(A.rows, B.cols, A.cols);
+    if (dim == split_dim::none) {
+        gemm_base(A, B, C, op);
+        return hpx::make_ready_future();
+    }
+
+    auto h = split_gemm(dim, A, B, C);
+    if (dim == split_dim::k) {
+        return recursive_gemm(h.a[0], h.b[0], h.c[0], op).then([h, op](hpx::future<void> first) {
+            first.get();
+            return recursive_gemm(h.a[1], h.b[1], h.c[1], op);
+        });
+    }
+
+    hpx::future<void> spawned = hpx::async([h, op]() { return recursive_gemm(h.a[0], h.b[0], h.c[0], op); });
+    hpx::future<void> inline_half = recursive_gemm(h.a[1], h.b[1], h.c[1], op);
+    return hpx::dataflow([](hpx::future<void> f0, hpx::future<void> f1) {
+        f0.get();
+        f1.get();
+    }, std::move(spawned), std::move(inline_half));
+}
+
+// Cache-oblivious divide and conquer: no block size to tune beyond the base case.
+// Accumulates into acc, which must be zero.
+template <class T>
+void multiply_matrices_recursive(matrix_view<const T> A, matrix_view<const T> B, matrix_view<accumulator_t<T>> acc, dense_matrix<result_t<T>> &C) {
+    recursive_gemm(A, B, acc, weighted<T>).get();
+    store_result(acc, C);
+}
+
+// Winograd's variant of Strassen on a square block whose size halves evenly down
+// to the cutoff. Near the root the seven products run as hpx::async tasks joined
+// with dataflow; deeper levels run inline so temporaries stay bounded.
+template <class Acc>
+hpx::future<void> strassen_gemm(buffer_pool<Acc>& pool, matrix_view<const Acc> A, matrix_view<const Acc> B, matrix_view<Acc> C, std::size_t cutoff, std::size_t depth) {
+    if (A.rows <= cutoff) {
+        for (std::size_t i = 0; i < C.rows; ++i) {
+            std::fill_n(C.row(i), C.cols, Acc{});
+        }
+        gemm_packed(A, B, C, [](Acc a) { return a; }, [](std::size_t n, auto&& f) {
+            for (std::size_t i = 0; i < n; ++i) f(i);
+        });
+        return hpx::make_ready_future();
+    }
+
+    auto ws = std::make_shared<strassen_workspace<Acc>>(pool, A.rows / 2);
+    auto products = winograd_operands(A, B, *ws);
+    std::vector<hpx::future<void>> pending;
+    pending.reserve(products.size());
+    for (std::size_t i = 0; i < products.size(); ++i) {
+        auto run = [&pool, p = products[i], out = ws->p(i), cutoff, depth]() {
+            return strassen_gemm<Acc>(pool, p.a, p.b, out, cutoff, depth + 1);
+        };
+        if (depth < strassen_parallel_depth) {
+            pending.push_back(hpx::async(run));
+        } else {
+            pending.push_back(run());
+        }
+    }
+
+    return hpx::dataflow([ws, C](std::vector<hpx::future<void>> done) {
+        for (auto& f : done) f.get();
+        winograd_combine(*ws, C);
+        ws->release();
+    }, std::move(pending));
+}
+
+// Operands padded to a size that halves evenly down to the cutoff, and the padded
+// product. Allocated once per size; the padding stays zero across runs.
+template <class Acc>
+struct strassen_operands {
+    strassen_operands(std::size_t n, std::size_t cutoff)
+        : n(n), padded(strassen_padded_size(n, cutoff)), a(make_matrix<Acc>(padded, padded, 0)), b(make_matrix<Acc>(padded, padded, 0)),
+          c(make_matrix<Acc>(padded, padded, 0)) {}
+
+    std::size_t n, padded;
+    dense_matrix<Acc> a, b, c;
+};
+
+// Copies A and B into the padded operands and runs strassen_gemm.
+template <class T>
+void multiply_matrices_strassen(matrix_view<const T> A, matrix_view<const T> B, strassen_operands<accumulator_t<T>>& w, dense_matrix<result_t<T>> &C, std::size_t cutoff) {
+    using Acc = accumulator_t<T>;
+    hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), w.n, [&](std::size_t i) {
+        for (std::size_t j = 0; j < w.n; ++j) {
+            w.a(i, j) = weighted(A(i, j));
+            w.b(i, j) = static_cast<Acc>(B(i, j));
+        }
+    });
+
+    buffer_pool<Acc> pool;
+    strassen_gemm<Acc>(pool, std::as_const(w.a).view(), std::as_const(w.b).view(), w.c.view(), cutoff, 0).get();
+    store_result(std::as_const(w.c).view().block(0, 0, w.n, w.n), C);
+}
+
+// Compares the last strassen result against the classic packed kernel and returns
+// false if the difference exceeds the Winograd error bound.
+template <class T>
+bool check_strassen(matrix_view<const T> A, matrix_view<const T> B, const strassen_operands<accumulator_t<T>>& w, std::size_t cutoff) {
+    using Acc = accumulator_t<T>;
+    dense_matrix<Acc> classic(w.n, w.n);
+    gemm_packed(A, B, classic.view(), weighted<T>, [](std::size_t count, auto&& f) {
+        hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), count, f);
+    });
+    Acc error = max_abs_diff<Acc>(w.c.view().block(0, 0, w.n, w.n), classic.view());
+    Acc bound = strassen_error_bound(w.padded, strassen_leaf_size(w.padded, cutoff), max_abs<Acc>(w.a.view()), max_abs<Acc>(w.b.view()));
+    bool within_bound = error <= bound;
+    std::cout << "Strassen check: max |C - C_classic| = " << error << ", bound = " << bound
+              << (within_bound ? " (ok)" : " (EXCEEDED)") << "\n";
+    return within_bound;
+}
+
+// Out-of-core product over matrix files within a memory budget. While the packed
+// kernel multiplies one pair of tiles, an hpx::async task reads the next pair into
+// the other buffer; finished C tiles are converted and written back by another,
+// and the futures are only waited on when a buffer is about to be reused.
+template <class T>
+void multiply_matrices_streaming(const matrix_tile_file<T> &A, const matrix_tile_file<T> &B, const matrix_tile_file<result_t<T>> &C, std::size_t budget_bytes) {
+    using Acc = accumulator_t<T>;
+    const std::size_t tile = streaming_tile_size<T, Acc>(budget_bytes);
+    const auto steps = streaming_steps(A.rows(), B.cols(), A.cols(), tile);
+    streaming_buffers<T, Acc> buffers(tile);
+    hpx::future<void> reads[2] = {hpx::make_ready_future(), hpx::make_ready_future()};
+    hpx::future<void> writes[2] = {hpx::make_ready_future(), hpx::make_ready_future()};
+
+    auto read_step = [&](std::size_t s) {
+        const int slot = s % 2;
+        reads[slot] = hpx::async([&A, &B, &buffers, st = steps[s], slot]() {
+            A.read(st.i0, st.k0, buffers.a_tile(slot, st));
+            B.read(st.k0, st.j0, buffers.b_tile(slot, st));
+        });
+    };
+
+    try {
+        if (!steps.empty()) read_step(0);
+        int c_slot = 0;
+        for (std::size_t s = 0; s < steps.size(); ++s) {
+            const streaming_step& st = steps[s];
+            reads[s % 2].get();
+            if (s + 1 < steps.size()) read_step(s + 1);
+
+            matrix_view<Acc> acc = buffers.c_tile(c_slot, st);
+            if (st.first_k) {
+                writes[c_slot].get();
+                for (std::size_t i = 0; i < acc.rows; ++i) {
+                    std::fill_n(acc.row(i), acc.cols, Acc{});
+                }
+            }
+            gemm_packed(buffers.a_tile(s % 2, st), buffers.b_tile(s % 2, st), acc, weighted<T>, [](std::size_t n, auto&& f) {
+                hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), n, f);
+            });
+            if (st.last_k) {
+                writes[c_slot] = hpx::async([&C, st, acc]() {
+                    write_back_tile<Acc>(C, st.i0, st.j0, acc);
+                });
+                c_slot = 1 - c_slot;
+            }
+        }
+        for (auto& w : writes) w.get();
+    } catch (...) {
+        for (auto& r : reads) if (r.valid()) r.wait();
+        for (auto& w : writes) if (w.valid()) w.wait();
+        throw;
+    }
+}
+
+// Builds the operands for one size, then has time_reps run the kernel once per
+// repetition: time_reps(prepare, kernel) calls prepare untimed before each timed
+// kernel call. The result is printed and saved once, after the last repetition.
+template <class T, class TimeReps>
+int run_benchmark(const std::string& kernel, int size, const options& opts, TimeReps&& time_reps) {
+    using R = result_t<T>;
+    using Acc = accumulator_t<T>;
+    auto nothing = []() {};
+
+    if (kernel == "naive") {
+        if (opts.has("a") || opts.has("b")) {
+            std::cerr << "File operands need a contiguous kernel (packed, recursive or strassen)\n";
+            return 1;
+        }
+        Matrix<T> A = make_row_matrix<T>(size, size, 1);
+        Matrix<T> B = make_row_matrix<T>(size, size, 1);
+        Matrix<R> C = make_row_matrix<R>(size, size, 0);
+
+        time_reps(nothing, [&]() { multiply_matrices(A, B, C); });
+        print_matrix(C, "C"); // Print top-left 5x5 portion
+    } else if (kernel == "chunked") {
+        std::string grain = opts.get("grain", std::string("rows"));
+        std::size_t tile = std::max(1L, opts.get("tile", 64L));
+        if (grain != "rows" && grain != "tiles") {
+            std::cerr << "Unknown grain: " << grain << " (expected rows or tiles)\n";
+            return 1;
+        }
+        block_grid grid{static_cast<std::size_t>(size), static_cast<std::size_t>(size),
+                        grain == "rows" ? 1 : tile, grain == "rows" ? static_cast<std::size_t>(size) : tile};
+        Matrix<T> A = make_row_matrix<T>(size, size, 1);
+        Matrix<T> B = make_row_matrix<T>(size, size, 1);
+        Matrix<R> C = make_row_matrix<R>(size, size, 0);
+
+        std::string chunk = opts.get("chunk", std::string("auto"));
+        bool known = with_chunking(chunk, std::max(0L, opts.get("chunk-size", 0L)), [&](auto policy) {
+            time_reps(nothing, [&]() { multiply_matrices_chunked(A, B, C, grid, policy); });
+        });
+        if (!known) {
+            std::cerr << "Unknown chunking: " << chunk << " (expected none, static, auto, guided or dynamic)\n";
+            return 1;
+        }
+        print_matrix(C, "C");
+    } else if (kernel == "packed" || kernel == "recursive" || kernel == "strassen") {
+        auto generate = [&]() { return make_matrix<T>(size, size, 1); };
+        input_matrix<T> A(opts.get("a", std::string()), generate);
+        input_matrix<T> B(opts.get("b", std::string()), generate);
+        dense_matrix<R> C;
+
+        if (A.view().cols != B.view().rows) {
+            std::cerr << "Inner dimensions differ: A is " << A.view().rows << "x" << A.view().cols
+                      << ", B is " << B.view().rows << "x" << B.view().cols << "\n";
+            return 1;
+        }
+
+        if (kernel == "packed" || kernel == "recursive") {
+            auto acc = make_matrix<Acc>(A.view().rows, B.view().cols, 0);
+            C = make_matrix<R>(A.view().rows, B.view().cols, 0);
+            auto zero_acc = [&]() {
+                init_loop()(acc.rows(), [&](std::size_t i) { std::fill_n(acc.view().row(i), acc.cols(), Acc{}); });
+            };
+            time_reps(zero_acc, [&]() {
+                if (kernel == "packed") {
+                    multiply_matrices_packed(A.view(), B.view(), acc.view(), C);
+                } else {
+                    multiply_matrices_recursive(A.view(), B.view(), acc.view(), C);
+                }
+            });
+        } else {
+            if (A.view().rows != A.view().cols || B.view().rows != B.view().cols) {
+                std::cerr << "The strassen kernel needs square operands\n";
+                return 1;
+            }
+            std::size_t cutoff = std::max(1L, opts.get("cutoff", static_cast<long>(strassen_default_cutoff)));
+            strassen_operands<Acc> w(A.view().rows, cutoff);
+            C = make_matrix<R>(A.view().rows, B.view().cols, 0);
+            time_reps(nothing, [&]() { multiply_matrices_strassen(A.view(), B.view(), w, C, cutoff); });
+            if (opts.has("check") && !check_strassen(A.view(), B.view(), w, cutoff)) return 1;
+        }
+        print_matrix(C.view(), "C");
+
+        std::string prefix = opts.get("save", std::string());
+        if (!prefix.empty()) {
+            write_matrix_file(prefix + ".a.mat", A.view());
+            write_matrix_file(prefix + ".b.mat", B.view());
+            write_matrix_file<R>(prefix + ".c.mat", C.view());
+        }
+    } else if (kernel == "streaming") {
+        std::string prefix = opts.get("save", std::string("streaming"));
+        std::string a_path = opts.get("a", std::string());
+        std::string b_path = opts.get("b", std::string());
+        if (a_path.empty()) fill_matrix_file<T>(a_path = prefix + ".a.mat", size, size, 1);
+        if (b_path.empty()) fill_matrix_file<T>(b_path = prefix + ".b.mat", size, size, 1);
+
+        matrix_tile_file<T> A(a_path);
+        matrix_tile_file<T> B(b_path);
+        if (A.cols() != B.rows()) {
+            std::cerr << "Inner dimensions differ: A is " << A.rows() << "x" << A.cols()
+                      << ", B is " << B.rows() << "x" << B.cols() << "\n";
+            return 1;
+        }
+        create_matrix_file<R>(prefix + ".c.mat", A.rows(), B.cols());
+        matrix_tile_file<R> C(prefix + ".c.mat", true);
+
+        std::size_t budget = static_cast<std::size_t>(std::max(1L, opts.get("memory", static_cast<long>(streaming_default_budget_mib)))) << 20;
+        time_reps(nothing, [&]() { multiply_matrices_streaming(A, B, C, budget); });
+
+        dense_matrix<R> corner(std::min<std::size_t>(5, C.rows()), std::min<std::size_t>(5, C.cols()));
+        C.read(0, 0, corner.view());
+        print_matrix(corner.view(), "C");
+    } else {
+        std::cerr << "Unknown kernel: " << kernel << " (expected naive, chunked, packed, recursive, strassen or streaming)\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+// HPX's counters for the compute phase, in the fields shared with system_scheduler.
+// Counters this HPX build lacks (idle rates, steal counts and overheads need the
+// HPX_WITH_THREAD_* options) are reported as null.
+class hpx_stats {
+public:
+    hpx_stats() : start(std::chrono::steady_clock::now()) {
+        for (const char* name : {"/threads{locality#0/total}/count/cumulative",
+                                 "/threads{locality#0/total}/count/stolen-from-pending",
+                                 "/threads{locality#0/total}/idle-rate",
+                                 "/threads{locality#0/total}/time/average-overhead"}) {
+            hpx::performance_counters::performance_counter counter;
+            try {
+                counter = hpx::performance_counters::performance_counter(std::string(name));
+                // Reading with reset starts the counter from zero.
+                counter.get_value<double>(hpx::launch::sync, true);
+            } catch (const hpx::exception&) {
+                counter = hpx::performance_counters::performance_counter();
+            }
+            counters.push_back(std::move(counter));
+        }
+    }
+
+    runtime_stats collect() {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return {{"threads", static_cast<double>(hpx::get_os_thread_count())},
+                {"tasks", value(0)},
+                {"steals", value(1)},
+                {"elapsed_s", elapsed.count()},
+                {"idle_rate", value(2) * 1e-4}, // reported in units of 0.01%
+                {"average_overhead_ns", value(3)}};
+    }
+
+private:
+    double value(std::size_t i) {
+        if (!counters[i].valid()) return std::numeric_limits<double>::quiet_NaN();
+        try {
+            return counters[i].get_value<double>(hpx::launch::sync);
+        } catch (const hpx::exception&) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+
+    std::chrono::steady_clock::time_point start;
+    std::vector<hpx::performance_counters::performance_counter> counters;
+};
+
 int main(int argc, char* argv[]) {
-    int size = 500;
-    if (argc >= 2) {
-        size = std::stoi(argv[1]);
-        if (size <= 0) return 1;
+    options opts(argc, argv);
+    std::vector<long> sizes = options::parse_list(opts.positional(0, "500"));
+    if (sizes.empty() || *std::min_element(sizes.begin(), sizes.end()) <= 0) return 1;
+    const long reps = std::max(1L, opts.get("reps", 1L));
+    std::string kernel = opts.positional(1, "naive");
+    std::string type = opts.get("type", std::string("int32"));
+    std::string init = opts.get("init", std::string("parallel"));
+    if (init != "parallel" && init != "serial") {
+        std::cerr << "Unknown initialisation: " << init << " (expected parallel or serial)\n";
+        return 1;
+    }
+    serial_init = init == "serial";
+    quiet = sizes.size() > 1 || reps > 1;
+
+    std::optional<cache_flusher> flusher;
+    if (opts.has("flush")) {
+        std::string mib = opts.get("flush", std::string());
+        flusher.emplace((mib.empty() ? cache_flush_default_mib : std::stoul(mib)) << 20);
     }
-    Matrix A(size, std::vector<int>(size, 1));
-    Matrix B(size, std::vector<int>(size, 1));
-    Matrix C;
 
-    multiply_matrices(A, B, C);
-    print_matrix(C, "C"); // Print top-left 5x5 portion
+    // Every size and repetition runs in this one HPX runtime, so the timings
+    // exclude process and runtime start-up. Operands are built once per size; each
+    // repetition flushes the caches if asked and resets the counters right before
+    // the kernel, so only the kernel is timed and counted. The stats printed are
+    // those of the fastest repetition.
+    for (long size : sizes) {
+        int status = 1;
+        bool known = true;
+        double best = 0, total = 0;
+        runtime_stats best_stats;
+        auto time_reps = [&](auto&& prepare, auto&& kernel) {
+            for (long r = 0; r < reps; ++r) {
+                prepare();
+                if (flusher) {
+                    flusher->flush([](std::size_t n, auto&& f) {
+                        hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), n, f);
+                    });
+                }
+                std::optional<hpx_stats> stats;
+                if (opts.has("stats")) stats.emplace();
+                auto start = std::chrono::steady_clock::now();
+                kernel();
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                if (r == 0 || elapsed.count() < best) {
+                    best = elapsed.count();
+                    if (stats) best_stats = stats->collect();
+                }
+                total += elapsed.count();
+            }
+        };
+        try {
+            known = dispatch_element_type(type, [&](auto tag) {
+                status = run_benchmark<typename decltype(tag)::type>(kernel, static_cast<int>(size), opts, time_reps);
+            });
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        if (!known) {
+            std::cerr << "Unknown element type: " << type << " (expected int32, int16, int8, float or double)\n";
+            return 1;
+        }
+        if (status != 0) return status;
+        print_record(std::cout, "result", "hpx",
+                     {{"size", static_cast<double>(size)}, {"reps", static_cast<double>(reps)}, {"best_s", best}, {"mean_s", total / reps}});
+        if (opts.has("stats")) print_runtime_stats(std::cout, "hpx", best_stats);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,93 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/future.hpp>
+#include "smith_waterman.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Smith-Waterman alignment of two length-n DNA sequences, the second a mutated
+// copy of the first, tiled for every size in --tile. "diagonal" runs one
+// parallel for_loop per anti-diagonal of tiles; "dataflow" builds the whole
+// wavefront as a graph of futures where each tile depends only on the tiles
+// north and west of it. Scores are checked against a serial DP.
+
+void run_diagonal(sw_tiles& s) {
+    for (std::size_t d = 0; d + 1 < s.tile_rows + s.tile_cols; ++d) {
+        const std::size_t first = d < s.tile_cols ? 0 : d - s.tile_cols + 1, last = std::min(d, s.tile_rows - 1);
+        hpx::experimental::for_loop(hpx::execution::par, first, last + 1, [&](std::size_t r) { s.run(r * s.tile_cols + d - r); });
+    }
+}
+
+void run_dataflow(sw_tiles& s) {
+    std::vector<hpx::shared_future<void>> done(s.count());
+    for (std::size_t t = 0; t < s.count(); ++t) {
+        std::vector<hpx::shared_future<void>> deps;
+        if (t >= s.tile_cols) deps.push_back(done[t - s.tile_cols]);
+        if (t % s.tile_cols > 0) deps.push_back(done[t - 1]);
+        done[t] = hpx::dataflow([&s, t](std::vector<hpx::shared_future<void>> ready) {
+            for (auto& f : ready) f.get();
+            s.run(t);
+        }, std::move(deps));
+    }
+    done.back().get();
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "8192"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::vector<long> tiles = options::parse_list(opts.get("tile", std::string("64,256,1024")));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "diagonal" && mode != "dataflow" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected diagonal, dataflow or all)\n";
+        return 1;
+    }
+    if (tiles.empty() || *std::min_element(tiles.begin(), tiles.end()) <= 0) {
+        std::cerr << "--tile must be a list of positive sizes\n";
+        return 1;
+    }
+
+    const std::string a = random_dna(n, opts.get("seed", 1L));
+    const std::string b = mutate_dna(a, 0.1, opts.get("seed", 1L) + 1);
+
+    auto start = std::chrono::steady_clock::now();
+    const int expected = sw_serial(a, b);
+    const double serial = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double cells = static_cast<double>(n) * n;
+    std::cout << n << " x " << n << " cells, serial " << serial * 1e3 << " ms, score " << expected << "\n";
+
+    for (long tile : tiles) {
+        sw_tiles probe(a, b, tile);
+        std::cout << "tile " << tile << " (" << probe.tile_rows << "x" << probe.tile_cols << " tiles, mean parallelism "
+                  << static_cast<double>(probe.count()) / (probe.tile_rows + probe.tile_cols - 1) << ")\n";
+        for (const char* name : {"diagonal", "dataflow"}) {
+            if (mode != "all" && mode != name) continue;
+
+            double best = 0;
+            int score = 0;
+            for (long r = 0; r < reps; ++r) {
+                sw_tiles s(a, b, tile);
+                start = std::chrono::steady_clock::now();
+                if (std::string(name) == "diagonal") {
+                    run_diagonal(s);
+                } else {
+                    run_dataflow(s);
+                }
+                const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                best = r == 0 ? elapsed : std::min(best, elapsed);
+                score = s.score();
+            }
+            std::cout << "  " << name << ": " << best * 1e3 << " ms (best of " << reps << "), " << cells / best * 1e-9
+                      << " GCUPS, speedup " << serial / best << ", score " << score << (score == expected ? "" : " MISMATCH") << "\n";
+        }
+    }
+    return 0;
+}
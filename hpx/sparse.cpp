@@ -0,0 +1,113 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include "matrix.hpp"
+#include "sparse.hpp"
+#include "options.hpp"
+#include "element_types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Sparse workload: y = A x (spmv) or Y = A X with a dense X of --k columns (spmm),
+// where A has power-law row lengths. Each partitioning is timed on the same
+// matrix and checked against a single-partition run.
+
+template <class T>
+double max_abs_diff(const std::vector<T>& x, const std::vector<T>& y) {
+    double result = 0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        result = std::max(result, std::abs(static_cast<double>(x[i]) - static_cast<double>(y[i])));
+    }
+    return result;
+}
+
+template <class T>
+int run_sparse(const std::string& op, std::size_t rows, const options& opts) {
+    using Acc = accumulator_t<T>;
+    const double avg_nnz = std::stod(opts.get("nnz", std::string("16")));
+    const double alpha = std::stod(opts.get("alpha", std::string("1.0")));
+    const std::size_t k = std::max(1L, opts.get("k", 16L));
+    const std::size_t parts = std::max(1L, opts.get("parts", static_cast<long>(std::thread::hardware_concurrency())));
+    const long reps = std::max(1L, opts.get("reps", 5L));
+    const std::string partition = opts.get("partition", std::string("both"));
+
+    if (op != "spmv" && op != "spmm") {
+        std::cerr << "Unknown operation: " << op << " (expected spmv or spmm)\n";
+        return 1;
+    }
+    if (partition != "rows" && partition != "merge" && partition != "both") {
+        std::cerr << "Unknown partitioning: " << partition << " (expected rows, merge or both)\n";
+        return 1;
+    }
+
+    auto A = power_law_matrix<T>(rows, rows, avg_nnz, alpha, opts.get("seed", 1L));
+    std::size_t longest = 0;
+    for (std::size_t i = 0; i < rows; ++i) longest = std::max(longest, A.row_ptr[i + 1] - A.row_ptr[i]);
+    std::cout << "A: " << rows << "x" << rows << ", nnz " << A.nnz() << ", longest row " << longest
+              << ", " << parts << " partitions\n";
+
+    const std::size_t width = op == "spmv" ? 1 : k;
+    dense_matrix<T> X(rows, width);
+    std::mt19937_64 rng(opts.get("seed", 1L) + 1);
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < width; ++j) X(i, j) = random_value<T>(rng);
+    }
+    std::vector<Acc> expected(rows * width), y(rows * width);
+    auto serial = [](std::size_t n, auto&& f) {
+        for (std::size_t i = 0; i < n; ++i) f(i);
+    };
+    auto parallel = [](std::size_t n, auto&& f) {
+        hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), n, f);
+    };
+    auto multiply = [&](const std::vector<merge_coord>& bounds, std::vector<Acc>& out, auto&& pf) {
+        if (op == "spmv") {
+            spmv(A, bounds, X.view().data, out.data(), pf);
+        } else {
+            spmm(A, bounds, std::as_const(X).view(), matrix_view<Acc>{out.data(), rows, width, width}, pf);
+        }
+    };
+    multiply(partition_bounds(A, sparse_partition::rows, 1), expected, serial);
+
+    for (auto kind : {sparse_partition::rows, sparse_partition::merge}) {
+        const char* name = kind == sparse_partition::rows ? "rows" : "merge";
+        if (partition != "both" && partition != name) continue;
+
+        auto bounds = partition_bounds(A, kind, parts);
+        double best = 0;
+        for (long r = 0; r < reps; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            multiply(bounds, y, parallel);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        std::cout << op << " " << name << ": " << best << " ms (best of " << reps << "), nnz max/mean "
+                  << partition_imbalance(bounds) << ", max |y - y_serial| " << max_abs_diff(y, expected) << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long rows = std::stol(opts.positional(0, "100000"));
+    if (rows <= 0) return 1;
+    std::string op = opts.positional(1, "spmv");
+    std::string type = opts.get("type", std::string("double"));
+
+    int status = 1;
+    bool known = dispatch_element_type(type, [&](auto tag) {
+        status = run_sparse<typename decltype(tag)::type>(op, rows, opts);
+    });
+    if (!known) {
+        std::cerr << "Unknown element type: " << type << " (expected int32, int16, int8, float or double)\n";
+        return 1;
+    }
+
+    return status;
+}
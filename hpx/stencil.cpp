@@ -0,0 +1,101 @@
+#include <hpx/hpx_main.hpp>
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/future.hpp>
+#include "stencil.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 2D heat diffusion over --tile x --tile tiles for --steps timesteps, advancing
+// every tile --block steps per task (temporal blocking when above 1). "barrier"
+// runs one parallel for_loop per task step; "dataflow" builds the whole run as a
+// graph of futures where each tile's next task step depends only on its own and
+// its neighbours' previous one.
+
+void run_barrier(heat_grid& g, const std::vector<std::size_t>& plan) {
+    for (std::size_t b = 0; b < plan.size(); ++b) {
+        auto src = std::as_const(g.buffers[b % 2]).view();
+        auto dst = g.buffers[(b + 1) % 2].view();
+        hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), g.tiles.size(), [&](std::size_t t) {
+            heat_advance(g, t, src, dst, plan[b]);
+        });
+    }
+}
+
+void run_dataflow(heat_grid& g, const std::vector<std::size_t>& plan) {
+    const std::size_t tiles = g.tiles.size();
+    std::vector<hpx::shared_future<void>> done(tiles, hpx::shared_future<void>(hpx::make_ready_future()));
+    for (std::size_t b = 0; b < plan.size(); ++b) {
+        std::vector<hpx::shared_future<void>> next(tiles);
+        for (std::size_t t = 0; t < tiles; ++t) {
+            std::vector<hpx::shared_future<void>> deps{done[t]};
+            for (std::size_t u : g.neighbours(t, heat_reach(plan, b))) deps.push_back(done[u]);
+            next[t] = hpx::dataflow([&g, &plan, t, b](std::vector<hpx::shared_future<void>> ready) {
+                for (auto& f : ready) f.get();
+                heat_advance(g, t, std::as_const(g.buffers[b % 2]).view(), g.buffers[(b + 1) % 2].view(), plan[b]);
+            }, std::move(deps));
+        }
+        done = std::move(next);
+    }
+    hpx::wait_all(done);
+    for (auto& f : done) f.get();
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "2048"));
+    if (n < 3) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::size_t steps = std::max(1L, opts.get("steps", 100L));
+    const std::size_t tile = std::max(1L, opts.get("tile", 128L));
+    const std::size_t block = std::min<std::size_t>(tile, std::max(1L, opts.get("block", 1L)));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "barrier" && mode != "dataflow" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected barrier, dataflow or all)\n";
+        return 1;
+    }
+
+    const auto plan = heat_plan(steps, block);
+    heat_grid g(n, tile);
+    std::optional<heat_grid> expected;
+    if (opts.has("check")) {
+        expected.emplace(n, n);
+        for (std::size_t b = 0; b < steps; ++b) {
+            heat_advance(*expected, 0, std::as_const(expected->buffers[b % 2]).view(), expected->buffers[(b + 1) % 2].view(), 1);
+        }
+    }
+
+    std::cout << n << "x" << n << " grid, " << g.tiles.size() << " tiles of " << tile << "x" << tile << ", " << steps
+              << " steps, " << block << " per task\n";
+    for (const char* name : {"barrier", "dataflow"}) {
+        if (mode != "all" && mode != name) continue;
+
+        double best = 0;
+        for (long r = 0; r < reps; ++r) {
+            g.reset();
+            auto start = std::chrono::steady_clock::now();
+            if (std::string(name) == "barrier") {
+                run_barrier(g, plan);
+            } else {
+                run_dataflow(g, plan);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        std::cout << name << ": " << best * 1e3 << " ms (best of " << reps << "), "
+                  << static_cast<double>(n) * n * steps / best * 1e-6 << " Mcells/s";
+        if (expected) {
+            std::cout << ", max |u - u_serial| "
+                      << heat_max_diff(std::as_const(g.buffers[plan.size() % 2]).view(), std::as_const(expected->buffers[steps % 2]).view());
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
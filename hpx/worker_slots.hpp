@@ -0,0 +1,71 @@
+#ifndef HPX_WORKER_SLOTS_HPP
+#define HPX_WORKER_SLOTS_HPP
+
+#include <hpx/algorithm.hpp>
+#include <hpx/execution.hpp>
+#include <hpx/runtime.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// One T per HPX worker thread, each on its own cache lines, so loop bodies can
+// accumulate without atomics and merge afterwards with combine() or for_each().
+// local() picks the slot of the calling worker; threads outside the runtime
+// share one extra slot. Loop bodies do not suspend, so an iteration stays on the
+// worker whose slot it picked. Merge only once the loops writing to the slots
+// have finished.
+template <class T>
+class worker_slots {
+public:
+    explicit worker_slots(const T& init = T{}) : count(hpx::get_num_worker_threads() + 1), slots(std::make_unique<slot[]>(count)) {
+        reset(init);
+    }
+
+    T& local() noexcept {
+        const std::size_t worker = hpx::get_worker_thread_num();
+        return slots[worker + 1 < count ? worker : count - 1].value;
+    }
+
+    std::size_t size() const noexcept { return count; }
+
+    template <class F>
+    void for_each(F&& f) {
+        for (std::size_t i = 0; i < count; ++i) f(slots[i].value);
+    }
+
+    template <class F>
+    void for_each(F&& f) const {
+        for (std::size_t i = 0; i < count; ++i) f(slots[i].value);
+    }
+
+    // Folds every slot into init with op(accumulated, slot).
+    template <class U, class Op>
+    U combine(U init, Op op) const {
+        for (std::size_t i = 0; i < count; ++i) init = op(std::move(init), slots[i].value);
+        return init;
+    }
+
+    void reset(const T& value) {
+        for (std::size_t i = 0; i < count; ++i) slots[i].value = value;
+    }
+
+private:
+    struct alignas(64) slot {
+        T value;
+    };
+
+    std::size_t count;
+    std::unique_ptr<slot[]> slots;
+};
+
+// f(begin, end) over [0, n) in chunks of `chunk` indices, one parallel for_loop
+// iteration per chunk.
+template <class F>
+void for_each_chunk(std::size_t n, std::size_t chunk, F&& f) {
+    hpx::experimental::for_loop(hpx::execution::par, std::size_t(0), (n + chunk - 1) / chunk, [&](std::size_t c) {
+        f(c * chunk, std::min(n, (c + 1) * chunk));
+    });
+}
+
+#endif // HPX_WORKER_SLOTS_HPP
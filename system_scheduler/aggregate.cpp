@@ -0,0 +1,148 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "worker_local.hpp"
+#include "aggregate.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Histogram of n Zipf-distributed keys into --buckets buckets, and group-by of
+// the same records into --groups keys (count and sum per key). Records are
+// processed in --chunk sized tasks, either into worker_local tables merged at
+// the end ("private") or into one atomic table ("shared"); "auto" picks by
+// table size. Every strategy is checked against a serial run.
+
+std::vector<std::uint64_t> histogram_private(std::execution::system_scheduler& scheduler, const aggregate_input& in,
+                                             std::size_t buckets, std::size_t chunk) {
+    const std::size_t n = in.keys.size();
+    worker_local<std::vector<std::uint64_t>> tables(scheduler, std::vector<std::uint64_t>(buckets));
+    parallel_for(scheduler, (n + chunk - 1) / chunk, [&](std::size_t c) {
+        histogram_add(tables.local(), in, c * chunk, std::min(n, (c + 1) * chunk));
+    });
+    // Merge by bucket ranges so each task reads one range of every worker's table.
+    std::vector<std::uint64_t> counts(buckets);
+    constexpr std::size_t range = 4096;
+    parallel_for(scheduler, (buckets + range - 1) / range, [&](std::size_t r) {
+        const std::size_t end = std::min(buckets, (r + 1) * range);
+        std::as_const(tables).for_each([&](const std::vector<std::uint64_t>& t) {
+            for (std::size_t b = r * range; b < end; ++b) counts[b] += t[b];
+        });
+    });
+    return counts;
+}
+
+std::vector<std::uint64_t> histogram_shared(std::execution::system_scheduler& scheduler, const aggregate_input& in,
+                                            std::size_t buckets, std::size_t chunk) {
+    const std::size_t n = in.keys.size();
+    std::vector<std::atomic<std::uint64_t>> shared(buckets);
+    parallel_for(scheduler, (n + chunk - 1) / chunk, [&](std::size_t c) {
+        histogram_add(shared, in, c * chunk, std::min(n, (c + 1) * chunk));
+    });
+    std::vector<std::uint64_t> counts(buckets);
+    for (std::size_t b = 0; b < buckets; ++b) counts[b] = shared[b].load(std::memory_order_relaxed);
+    return counts;
+}
+
+group_table group_by_private(std::execution::system_scheduler& scheduler, const aggregate_input& in,
+                                            std::size_t groups, std::size_t chunk) {
+    const std::size_t n = in.keys.size();
+    worker_local<group_table> tables(scheduler, group_table(groups));
+    parallel_for(scheduler, (n + chunk - 1) / chunk, [&](std::size_t c) {
+        tables.local().add(in, c * chunk, std::min(n, (c + 1) * chunk));
+    });
+    return tables.combine(group_table(groups), [](group_table acc, const group_table& t) {
+        acc.merge(t);
+        return acc;
+    });
+}
+
+shared_group_table group_by_shared(std::execution::system_scheduler& scheduler, const aggregate_input& in,
+                                           std::size_t groups, std::size_t chunk) {
+    const std::size_t n = in.keys.size();
+    shared_group_table table(groups);
+    parallel_for(scheduler, (n + chunk - 1) / chunk, [&](std::size_t c) {
+        table.add(in, c * chunk, std::min(n, (c + 1) * chunk));
+    });
+    return table;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "10000000"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::size_t buckets = std::max(1L, opts.get("buckets", 256L));
+    const std::size_t groups = std::max(1L, opts.get("groups", 100000L));
+    const double skew = std::stod(opts.get("skew", std::string("1.0")));
+    const std::size_t chunk = std::max(1L, opts.get("chunk", 16384L));
+    const std::string strategy = opts.get("strategy", std::string("all"));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "histogram" && mode != "group-by" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected histogram, group-by or all)\n";
+        return 1;
+    }
+    if (strategy != "private" && strategy != "shared" && strategy != "auto" && strategy != "all") {
+        std::cerr << "Unknown strategy: " << strategy << " (expected private, shared, auto or all)\n";
+        return 1;
+    }
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+    const auto in = zipf_records(n, groups, skew, opts.get("seed", 1L));
+    std::cout << n << " records, " << groups << " keys, skew " << skew << "\n";
+
+    for (const char* kernel : {"histogram", "group-by"}) {
+        if (mode != "all" && mode != kernel) continue;
+        const bool histogram = std::string(kernel) == "histogram";
+
+        std::vector<std::uint64_t> expected;
+        std::size_t table_bytes;
+        if (histogram) {
+            expected.assign(buckets, 0);
+            histogram_add(expected, in, 0, n);
+            table_bytes = buckets * sizeof(std::uint64_t);
+        } else {
+            group_table serial(groups);
+            serial.add(in, 0, n);
+            expected = group_totals(serial, groups);
+            table_bytes = serial.bytes();
+        }
+        const std::string chosen = prefer_private(table_bytes) ? "private" : "shared";
+        std::cout << kernel << ": " << table_bytes / 1024 << " KiB table, auto picks " << chosen << "\n";
+
+        for (const char* name : {"private", "shared"}) {
+            if (strategy != "all" && strategy != name && !(strategy == "auto" && chosen == name)) continue;
+            const bool priv = std::string(name) == "private";
+
+            double best = 0;
+            std::vector<std::uint64_t> result;
+            for (long r = 0; r < reps; ++r) {
+                auto start = std::chrono::steady_clock::now();
+                std::chrono::duration<double> elapsed;
+                if (histogram) {
+                    result = priv ? histogram_private(scheduler, in, buckets, chunk) : histogram_shared(scheduler, in, buckets, chunk);
+                    elapsed = std::chrono::steady_clock::now() - start;
+                } else if (priv) {
+                    const auto table = group_by_private(scheduler, in, groups, chunk);
+                    elapsed = std::chrono::steady_clock::now() - start;
+                    result = group_totals(table, groups);
+                } else {
+                    const auto table = group_by_shared(scheduler, in, groups, chunk);
+                    elapsed = std::chrono::steady_clock::now() - start;
+                    result = group_totals(table, groups);
+                }
+                best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+            }
+            std::cout << kernel << " " << name << ": " << best * 1e3 << " ms (best of " << reps << "), " << n / best * 1e-6
+                      << " Mrecords/s, " << (result == expected ? "matches serial" : "MISMATCH") << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "gemm_batched.hpp"
+#include "options.hpp"
+#include "element_types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Batched small GEMM: `count` independent n x n products submitted as one task per
+// matrix, one task per group of --batch matrices, or one bulk_schedule over all
+// matrices. The work per task is tiny, so throughput measures scheduling overhead.
+
+// Spins until `remaining` drops to zero; the caller is outside the worker pool.
+void wait_for(const std::atomic<std::size_t>& remaining) {
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+template <std::size_t N, class T, class Acc>
+void run_batched(std::execution::system_scheduler& scheduler, const std::string& mode, const gemm_batch<T, Acc>& batch, std::size_t group) {
+    if (mode == "task") {
+        std::atomic<std::size_t> remaining(batch.count);
+        for (std::size_t i = 0; i < batch.count; ++i) {
+            scheduler.schedule([&batch, &remaining, i]() {
+                multiply_batch_range<N>(batch, i, i + 1);
+                remaining.fetch_sub(1, std::memory_order_release);
+            }, std::execution::priority_t::NORMAL);
+        }
+        wait_for(remaining);
+    } else if (mode == "batch") {
+        const std::size_t tasks = (batch.count + group - 1) / group;
+        std::atomic<std::size_t> remaining(tasks);
+        for (std::size_t t = 0; t < tasks; ++t) {
+            scheduler.schedule([&batch, &remaining, group, t]() {
+                multiply_batch_range<N>(batch, t * group, std::min(batch.count, (t + 1) * group));
+                remaining.fetch_sub(1, std::memory_order_release);
+            }, std::execution::priority_t::NORMAL);
+        }
+        wait_for(remaining);
+    } else {
+        parallel_for(scheduler, batch.count, [&batch](std::size_t i) {
+            multiply_batch_range<N>(batch, i, i + 1);
+        });
+    }
+}
+
+template <class T>
+int run_benchmark(std::execution::system_scheduler& scheduler, const std::string& mode, std::size_t count, const options& opts) {
+    using Acc = accumulator_t<T>;
+    const std::size_t n = std::max(1L, opts.get("n", 16L));
+    const std::size_t group = std::max(1L, opts.get("batch", 64L));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "task" && mode != "batch" && mode != "bulk" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected task, batch, bulk or all)\n";
+        return 1;
+    }
+
+    gemm_batch<T, Acc> batch(count, n);
+    fill_batch(batch, opts.get("seed", 1L));
+
+    // Serial results for a sample of matrices, to check every mode against.
+    const std::size_t sample_step = std::max<std::size_t>(1, count / 64);
+    gemm_batch<T, Acc> expected(1, n);
+    auto check = [&]() {
+        double error = 0;
+        for (std::size_t i = 0; i < count; i += sample_step) {
+            small_gemm<0>(batch.a_matrix(i), batch.b_matrix(i), expected.c_matrix(0), n);
+            for (std::size_t e = 0; e < n * n; ++e) {
+                error = std::max(error, std::abs(static_cast<double>(batch.c_matrix(i)[e]) - static_cast<double>(expected.c_matrix(0)[e])));
+            }
+        }
+        return error;
+    };
+
+    const double flops = 2.0 * n * n * n * count;
+    for (const char* name : {"task", "batch", "bulk"}) {
+        if (mode != "all" && mode != name) continue;
+
+        std::fill_n(batch.c.data(), count * n * n, Acc{});
+        double best = 0;
+        for (long r = 0; r < reps; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            dispatch_small_size(n, [&](auto size) {
+                run_batched<decltype(size)::value>(scheduler, name, batch, group);
+            });
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        std::cout << name << ": " << count << " x " << n << "x" << n << " in " << best * 1e3 << " ms (best of " << reps
+                  << "), " << count / best << " matrices/s, " << flops / best * 1e-9 << " GFLOP/s, max error " << check() << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long count = std::stol(opts.positional(0, "100000"));
+    if (count <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    std::string type = opts.get("type", std::string("float"));
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+
+    int status = 1;
+    bool known = dispatch_element_type(type, [&](auto tag) {
+        status = run_benchmark<typename decltype(tag)::type>(scheduler, mode, count, opts);
+    });
+    if (!known) {
+        std::cerr << "Unknown element type: " << type << " (expected int32, int16, int8, float or double)\n";
+        return 1;
+    }
+
+    return status;
+}
@@ -0,0 +1,146 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "fft.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Forward complex FFT of n points (1d), or of an n / --cols x --cols matrix (2d).
+// 1d forks one task per sub-transform down to --grain points and runs each
+// butterfly pass above that as a bulk_schedule over --grain sized index blocks;
+// 2d runs bulk passes over rows and cache-blocked transposes. --check compares
+// against a naive DFT (small sizes) or a serial FFT.
+
+// Butterflies of a length-n transform in blocks of grain indices through
+// bulk_schedule; the block that finishes last calls done.
+void combine_then(std::execution::system_scheduler& scheduler, cplx* out, std::size_t n, const cplx* w, std::size_t w_step,
+                  std::size_t grain, std::function<void()> done) {
+    const std::size_t m = n / fft_radix(n), blocks = (m + grain - 1) / grain;
+    if (blocks == 1) {
+        fft_combine(out, n, w, w_step, 0, m);
+        done();
+        return;
+    }
+    auto remaining = std::make_shared<std::atomic<std::size_t>>(blocks);
+    scheduler.bulk_schedule(static_cast<uint32_t>(blocks), [=](uint32_t b) {
+        fft_combine(out, n, w, w_step, b * grain, std::min(m, (b + 1) * grain));
+        if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) done();
+    });
+}
+
+void fft_task(std::execution::system_scheduler& scheduler, const cplx* in, std::size_t stride, cplx* out, std::size_t n,
+              const cplx* w, std::size_t w_step, std::size_t grain, std::function<void()> done) {
+    if (n <= grain) {
+        fft_serial(in, stride, out, n, w, w_step);
+        done();
+        return;
+    }
+    const std::size_t r = fft_radix(n), m = n / r;
+    auto pending = std::make_shared<std::atomic<std::size_t>>(r);
+    std::function<void()> join = [&scheduler, pending, out, n, w, w_step, grain, done]() {
+        if (pending->fetch_sub(1, std::memory_order_acq_rel) == 1) combine_then(scheduler, out, n, w, w_step, grain, done);
+    };
+    for (std::size_t q = 0; q + 1 < r; ++q) {
+        scheduler.schedule([&scheduler, in, stride, out, q, r, m, w, w_step, grain, join]() {
+            fft_task(scheduler, in + q * stride, stride * r, out + q * m, m, w, w_step * r, grain, join);
+        }, std::execution::priority_t::NORMAL);
+    }
+    fft_task(scheduler, in + (r - 1) * stride, stride * r, out + (r - 1) * m, m, w, w_step * r, grain, join);
+}
+
+void fft_parallel(std::execution::system_scheduler& scheduler, const std::vector<cplx>& in, std::vector<cplx>& out,
+                  const std::vector<cplx>& w, std::size_t grain) {
+    std::atomic<bool> finished(false);
+    scheduler.schedule([&]() {
+        fft_task(scheduler, in.data(), 1, out.data(), in.size(), w.data(), 1, grain,
+                 [&finished]() { finished.store(true, std::memory_order_release); });
+    }, std::execution::priority_t::NORMAL);
+    while (!finished.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "1048576"));
+    std::string mode = opts.positional(1, "all");
+    const std::size_t grain = std::max(2L, opts.get("grain", 4096L));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+    std::size_t cols = 1;
+    while (cols * cols * 4 <= static_cast<std::size_t>(n)) cols *= 2;
+    cols = std::max(1L, opts.get("cols", static_cast<long>(cols)));
+
+    if (n <= 0 || !is_power_of_two(n) || !is_power_of_two(cols) || cols > static_cast<std::size_t>(n)) {
+        std::cerr << "n and --cols must be powers of two with --cols <= n\n";
+        return 1;
+    }
+    if (mode != "1d" && mode != "2d" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected 1d, 2d or all)\n";
+        return 1;
+    }
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+    const std::vector<cplx> x = random_signal(n, opts.get("seed", 1L));
+    const double flops = 5.0 * n * std::log2(static_cast<double>(n));
+
+    for (const char* name : {"1d", "2d"}) {
+        if (mode != "all" && mode != name) continue;
+        const bool two_d = std::string(name) == "2d";
+        const std::size_t rows = n / cols;
+
+        std::vector<cplx> y(n);
+        dense_matrix<cplx> in2(rows, cols), out2(rows, cols);
+        for (std::size_t i = 0; i < rows; ++i) std::copy_n(x.data() + i * cols, cols, &in2(i, 0));
+        const auto w = fft_twiddles(n);
+        fft_2d_plan plan(rows, cols);
+        auto parallel_blocks = [&scheduler](std::size_t count, auto&& f) { parallel_for(scheduler, count, f); };
+
+        double best = 0;
+        for (long r = 0; r < reps; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            if (two_d) {
+                plan.run(parallel_blocks, std::as_const(in2).view(), out2.view());
+            } else {
+                fft_parallel(scheduler, x, y, w, grain);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        std::cout << name;
+        if (two_d) std::cout << " (" << rows << "x" << cols << ")";
+        std::cout << ": " << best * 1e3 << " ms (best of " << reps << "), " << flops / best * 1e-9 << " GFLOP/s";
+
+        if (opts.has("check")) {
+            const bool naive = n <= (two_d ? 65536 : 4096);
+            double error = 0;
+            if (two_d) {
+                dense_matrix<cplx> expected(rows, cols);
+                if (naive) {
+                    expected = naive_dft_2d(std::as_const(in2).view());
+                } else {
+                    plan.run([](std::size_t count, auto&& f) { for (std::size_t b = 0; b < count; ++b) f(b); }, std::as_const(in2).view(), expected.view());
+                }
+                for (std::size_t i = 0; i < rows; ++i) error = std::max(error, max_abs_error(&out2(i, 0), &expected(i, 0), cols));
+            } else {
+                std::vector<cplx> expected(n);
+                if (naive) {
+                    expected = naive_dft(x.data(), 1, n);
+                } else {
+                    fft_serial(x.data(), 1, expected.data(), n, w.data(), 1);
+                }
+                error = max_abs_error(y, expected, n);
+            }
+            std::cout << ", max error vs " << (naive ? "naive DFT " : "serial FFT ") << error;
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "worker_local.hpp"
+#include "hash_join.hpp"
+#include "options.hpp"
+#include "timing.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Hash join of R (n tuples, unique keys) with S (--probe-ratio * n tuples).
+// "partitioned" scatters both relations by --bits radix bits of the key hash into
+// worker_local per-partition buffers, then builds one small table per partition
+// and probes it, each phase one bulk_schedule. "shared" builds a single table
+// with CAS inserts and probes it. Phases are timed separately and every result
+// is checked against a serial join.
+
+using partition_buffers = std::vector<std::vector<join_tuple>>;
+
+struct join_times {
+    double partition = 0, build = 0, probe = 0;
+};
+
+template <class F>
+void for_each_chunk(std::execution::system_scheduler& scheduler, std::size_t n, std::size_t chunk, F&& f) {
+    parallel_for(scheduler, (n + chunk - 1) / chunk, [&](std::size_t c) { f(c * chunk, std::min(n, (c + 1) * chunk)); });
+}
+
+join_result join_partitioned(std::execution::system_scheduler& scheduler, const join_input& in, unsigned bits, std::size_t chunk,
+                             join_times& times) {
+    const std::size_t parts = std::size_t(1) << bits;
+    auto t0 = clock_type::now();
+    worker_local<partition_buffers> r_parts(scheduler, partition_buffers(parts)), s_parts(scheduler, partition_buffers(parts));
+    auto scatter = [&](const std::vector<join_tuple>& rel, worker_local<partition_buffers>& out) {
+        for_each_chunk(scheduler, rel.size(), chunk, [&](std::size_t begin, std::size_t end) {
+            auto& mine = out.local();
+            for (std::size_t i = begin; i < end; ++i) mine[join_partition(rel[i].key, bits)].push_back(rel[i]);
+        });
+    };
+    scatter(in.r, r_parts);
+    scatter(in.s, s_parts);
+
+    auto t1 = clock_type::now();
+    std::vector<join_table> tables(parts);
+    parallel_for(scheduler, parts, [&](std::size_t p) {
+        std::size_t count = 0;
+        std::as_const(r_parts).for_each([&](const partition_buffers& b) { count += b[p].size(); });
+        tables[p] = join_table(count);
+        std::as_const(r_parts).for_each([&](const partition_buffers& b) {
+            for (const auto& t : b[p]) tables[p].insert(t);
+        });
+    });
+
+    auto t2 = clock_type::now();
+    worker_local<join_result> results(scheduler);
+    parallel_for(scheduler, parts, [&](std::size_t p) {
+        auto& mine = results.local();
+        std::as_const(s_parts).for_each([&](const partition_buffers& b) {
+            for (const auto& t : b[p]) tables[p].probe(t, mine);
+        });
+    });
+    const join_result result = results.combine(join_result{}, [](join_result acc, const join_result& r) { return acc += r; });
+    auto t3 = clock_type::now();
+
+    times.partition += ms_between(t0, t1);
+    times.build += ms_between(t1, t2);
+    times.probe += ms_between(t2, t3);
+    return result;
+}
+
+join_result join_shared(std::execution::system_scheduler& scheduler, const join_input& in, std::size_t chunk, join_times& times) {
+    auto t0 = clock_type::now();
+    shared_join_table table(in.r.size());
+    for_each_chunk(scheduler, in.r.size(), chunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) table.insert(in.r[i]);
+    });
+
+    auto t1 = clock_type::now();
+    worker_local<join_result> results(scheduler);
+    for_each_chunk(scheduler, in.s.size(), chunk, [&](std::size_t begin, std::size_t end) {
+        auto& mine = results.local();
+        for (std::size_t i = begin; i < end; ++i) table.probe(in.s[i], mine);
+    });
+    const join_result result = results.combine(join_result{}, [](join_result acc, const join_result& r) { return acc += r; });
+    auto t2 = clock_type::now();
+
+    times.build += ms_between(t0, t1);
+    times.probe += ms_between(t1, t2);
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "4000000"));
+    if (n <= 0 || n >= (1L << 32) - 1) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::size_t probe_size = n * std::max(1L, opts.get("probe-ratio", 4L));
+    const unsigned bits = static_cast<unsigned>(std::clamp(opts.get("bits", static_cast<long>(join_auto_bits(n))), 0L, 16L));
+    const std::size_t chunk = std::max(1L, opts.get("chunk", 16384L));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "partitioned" && mode != "shared" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected partitioned, shared or all)\n";
+        return 1;
+    }
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+    const join_input in = join_relations(n, probe_size, opts.get("seed", 1L));
+    const join_result expected = join_reference(in);
+    std::cout << "|R| " << n << ", |S| " << probe_size << ", " << (1 << bits) << " partitions\n";
+
+    for (const char* name : {"partitioned", "shared"}) {
+        if (mode != "all" && mode != name) continue;
+        const bool partitioned = std::string(name) == "partitioned";
+
+        double best = 0;
+        join_times times;
+        join_result result;
+        for (long r = 0; r < reps; ++r) {
+            auto start = clock_type::now();
+            result = partitioned ? join_partitioned(scheduler, in, bits, chunk, times) : join_shared(scheduler, in, chunk, times);
+            const double elapsed = ms_between(start, clock_type::now());
+            best = r == 0 ? elapsed : std::min(best, elapsed);
+        }
+        std::cout << name << ": " << best << " ms (best of " << reps << "), " << (n + probe_size) / best * 1e-3 << " Mtuples/s; mean";
+        if (partitioned) std::cout << " partition " << times.partition / reps << " ms,";
+        std::cout << " build " << times.build / reps << " ms, probe " << times.probe / reps << " ms; " << result.matches << " matches, "
+                  << (result.matches == expected.matches && result.checksum == expected.checksum ? "matches serial" : "MISMATCH")
+                  << "\n";
+    }
+    return 0;
+}
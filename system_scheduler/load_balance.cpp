@@ -0,0 +1,104 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "worker_local.hpp"
+#include "irregular.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loops with uneven iteration costs, run under three schedules:
+//   static - one contiguous block of indices per worker, as in the matrix
+//            benchmark's row split
+//   bulk   - bulk_schedule's own chunking, balanced by work stealing
+//   lazy   - lazy_parallel_for, splitting ranges of more than --grain indices
+//            only while the calling worker's own queue is empty
+// The workloads are the rows of an n x n Mandelbrot image ("mandelbrot") and n
+// indices of a spin kernel whose cost follows --pattern ("variable"). Each
+// schedule reports its speedup over a serial loop and the load imbalance across
+// workers, measured in the kernels' work units.
+
+template <class Body>
+void run_schedule(std::execution::system_scheduler& scheduler, const std::string& schedule, std::size_t n, std::size_t grain,
+                  worker_local<double>& loads, Body& body) {
+    auto index = [&](std::size_t i) { loads.local() += static_cast<double>(body(i)); };
+    if (schedule == "static") {
+        const std::size_t parts = scheduler.get_thread_count();
+        parallel_for(scheduler, parts, [&](std::size_t p) {
+            for (std::size_t i = p * n / parts; i < (p + 1) * n / parts; ++i) index(i);
+        });
+    } else if (schedule == "bulk") {
+        parallel_for(scheduler, n, index);
+    } else {
+        lazy_parallel_for(scheduler, n, grain, index);
+    }
+}
+
+template <class Body>
+void compare_schedules(std::execution::system_scheduler& scheduler, std::size_t n, std::size_t grain, long reps, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) body(i);
+    const double serial = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "serial: " << serial * 1e3 << " ms\n";
+
+    for (const char* schedule : {"static", "bulk", "lazy"}) {
+        double best = 0, imbalance = 0;
+        for (long r = 0; r < reps; ++r) {
+            worker_local<double> loads(scheduler);
+            start = std::chrono::steady_clock::now();
+            run_schedule(scheduler, schedule, n, grain, loads, body);
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (r == 0 || elapsed < best) {
+                best = elapsed;
+                std::vector<double> per_worker;
+                loads.for_each([&per_worker](double l) { per_worker.push_back(l); });
+                imbalance = load_imbalance(per_worker, scheduler.get_thread_count());
+            }
+        }
+        std::cout << schedule << ": " << best * 1e3 << " ms (best of " << reps << "), speedup " << serial / best << ", imbalance "
+                  << imbalance << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "1024"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::string pattern = opts.get("pattern", std::string("spike"));
+    const std::size_t grain = std::max(1L, opts.get("grain", 4L));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "mandelbrot" && mode != "variable" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected mandelbrot, variable or all)\n";
+        return 1;
+    }
+    if (!known_cost_pattern(pattern)) {
+        std::cerr << "Unknown pattern: " << pattern << " (expected uniform, linear, spike or random)\n";
+        return 1;
+    }
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+    std::cout << scheduler.get_thread_count() << " workers\n";
+
+    if (mode != "variable") {
+        mandelbrot_image image(n, n, static_cast<std::uint32_t>(std::max(1L, opts.get("max-iter", 1000L))));
+        std::cout << "mandelbrot " << n << "x" << n << ", max " << image.max_iter << " iterations, one row per index\n";
+        compare_schedules(scheduler, n, grain, reps, [&image](std::size_t y) { return image.row(y); });
+    }
+    if (mode != "mandelbrot") {
+        const auto units = cost_profile(pattern, n, static_cast<std::uint32_t>(std::clamp(opts.get("cost", 100000L), 1L, 1L << 24)),
+                                        opts.get("seed", 1L));
+        std::vector<double> out(n);
+        std::cout << "variable cost, " << n << " indices, " << pattern << " pattern\n";
+        compare_schedules(scheduler, n, grain, reps, [&](std::size_t i) {
+            out[i] = spin(units[i], static_cast<double>(i));
+            return static_cast<std::uint64_t>(units[i]) + 1;
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "monte_carlo.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Monte Carlo estimates of pi ("pi") and of a European call price ("option")
+// from n samples, split into blocks of --block samples with one bulk_schedule
+// index per block. Every block draws its own Philox stream keyed by --seed and
+// the block index and writes its partial result to its own slot, which are
+// summed in block order. Runs report speedup over the serial loop and whether
+// the estimate matches it exactly; --block sets the task granularity.
+
+template <class F>
+double seconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "16777216"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::size_t block_size = std::max(1L, opts.get("block", 65536L));
+    const std::uint64_t seed = opts.get("seed", 1L);
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "pi" && mode != "option" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected pi, option or all)\n";
+        return 1;
+    }
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+    const std::size_t samples = n, blocks = (samples + block_size - 1) / block_size;
+    const option_params params;
+    std::cout << samples << " samples in " << blocks << " blocks of " << block_size << "\n";
+
+    for (const char* name : {"pi", "option"}) {
+        if (mode != "all" && mode != name) continue;
+        const bool pi = std::string(name) == "pi";
+
+        std::vector<std::uint64_t> inside(blocks);
+        std::vector<payoff_sum> payoffs(blocks);
+        auto block = [&](std::size_t b) {
+            if (pi) {
+                inside[b] = pi_block(seed, b, block_samples(samples, block_size, b));
+            } else {
+                payoffs[b] = option_block(seed, b, block_samples(samples, block_size, b), params);
+            }
+        };
+        auto estimate = [&]() {
+            if (pi) {
+                std::uint64_t total = 0;
+                for (auto c : inside) total += c;
+                return 4.0 * static_cast<double>(total) / static_cast<double>(samples);
+            }
+            payoff_sum total;
+            for (const auto& s : payoffs) total += s;
+            return std::exp(-params.rate * params.years) * total.sum / static_cast<double>(samples);
+        };
+
+        const double serial = seconds([&]() {
+            for (std::size_t b = 0; b < blocks; ++b) block(b);
+        });
+        const double expected = estimate();
+
+        double best = 0;
+        for (long r = 0; r < reps; ++r) {
+            // Cleared so a block the parallel run skipped cannot keep its serial result.
+            std::fill(inside.begin(), inside.end(), 0);
+            payoffs.assign(blocks, {});
+            const double elapsed = seconds([&]() { parallel_for(scheduler, blocks, block); });
+            best = r == 0 ? elapsed : std::min(best, elapsed);
+        }
+        const double result = estimate();
+
+        std::cout << name << ": " << best * 1e3 << " ms (best of " << reps << "), " << samples / best * 1e-6 << " Msamples/s, speedup "
+                  << serial / best << "; estimate " << result;
+        if (pi) {
+            std::cout << ", error " << std::abs(result - M_PI);
+        } else {
+            payoff_sum total;
+            for (const auto& s : payoffs) total += s;
+            const double mean = total.sum / samples, variance = std::max(0.0, total.sum_sq / samples - mean * mean);
+            std::cout << ", Black-Scholes " << black_scholes_call(params) << ", standard error "
+                      << std::exp(-params.rate * params.years) * std::sqrt(variance / samples);
+        }
+        std::cout << ", " << (result == expected ? "matches serial" : "MISMATCH") << "\n";
+    }
+    return 0;
+}
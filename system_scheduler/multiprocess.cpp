@@ -0,0 +1,121 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "matrix.hpp"
+#include "gemm_pipeline.hpp"
+#include "gemm_recursive.hpp"
+#include "options.hpp"
+#include "element_types.hpp"
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Multi-process baseline for the distributed HPX run: --procs forked processes,
+// each with its own system_scheduler, compute contiguous row ranges of
+// C = weighted(A) * B. A, B and C live in one shared anonymous mapping, so no
+// data is copied between processes. Times include fork and worker start-up.
+
+using element = double;
+
+struct shared_matrices {
+    explicit shared_matrices(std::size_t n) : n(n), bytes(3 * n * n * sizeof(element)) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("mmap of shared matrices failed");
+        base = static_cast<element*>(p);
+    }
+    ~shared_matrices() { munmap(base, bytes); }
+    shared_matrices(const shared_matrices&) = delete;
+    shared_matrices& operator=(const shared_matrices&) = delete;
+
+    matrix_view<element> A() const { return {base, n, n, n}; }
+    matrix_view<element> B() const { return {base + n * n, n, n, n}; }
+    matrix_view<element> C() const { return {base + 2 * n * n, n, n, n}; }
+
+    std::size_t n;
+    std::size_t bytes;
+    element* base;
+};
+
+// Runs in a child: C[r0, r1) = weighted(A[r0, r1)) * B on a fresh scheduler.
+void multiply_rows(const shared_matrices& M, std::size_t r0, std::size_t r1, unsigned threads) {
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, threads);
+    const std::size_t blocks = (r1 - r0 + first_touch_rows - 1) / first_touch_rows;
+    parallel_for(scheduler, blocks, [&](std::size_t b) {
+        const std::size_t first = r0 + b * first_touch_rows;
+        const std::size_t rows = std::min(r1, first + first_touch_rows) - first;
+        auto C = M.C().block(first, 0, rows, M.n);
+        for (std::size_t i = 0; i < rows; ++i) std::fill_n(C.row(i), M.n, element{});
+        gemm_base(matrix_view<const element>(M.A().block(first, 0, rows, M.n)), matrix_view<const element>(M.B()), C,
+                  [](element a) { return weighted(a); });
+    });
+}
+
+// Forks one child per row range and waits for all of them; false if any failed.
+bool run_processes(const shared_matrices& M, std::size_t procs, unsigned threads) {
+    std::vector<pid_t> children;
+    for (std::size_t p = 0; p < procs; ++p) {
+        const std::size_t r0 = M.n * p / procs, r1 = M.n * (p + 1) / procs;
+        pid_t pid = fork();
+        if (pid == 0) {
+            multiply_rows(M, r0, r1, threads);
+            _exit(0);
+        }
+        if (pid < 0) {
+            std::cerr << "fork failed\n";
+            break;
+        }
+        children.push_back(pid);
+    }
+    bool ok = children.size() == procs;
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "1024"));
+    if (n <= 0) return 1;
+    const unsigned hardware = std::max(1U, std::thread::hardware_concurrency());
+    const std::size_t procs = std::max(1L, opts.get("procs", 2L));
+    const unsigned threads = std::max<unsigned>(1, opts.get("threads", static_cast<long>(hardware / procs)));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    shared_matrices M(n);
+    for (std::size_t i = 0; i < M.n; ++i) {
+        for (std::size_t j = 0; j < M.n; ++j) {
+            M.A()(i, j) = gemm_pipeline<element>::a_value(i, j);
+            M.B()(i, j) = gemm_pipeline<element>::b_value(i, j);
+        }
+    }
+
+    double best = 0;
+    for (long r = 0; r < reps; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        if (!run_processes(M, procs, threads)) {
+            std::cerr << "A worker process failed\n";
+            return 1;
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    double checksum = 0;
+    for (std::size_t i = 0; i < M.n; ++i) {
+        for (std::size_t j = 0; j < M.n; ++j) checksum += M.C()(i, j);
+    }
+    const double expected = gemm_pipeline<element>::expected_total(n);
+    std::cout << procs << " processes x " << threads << " threads: " << best << " ms (best of " << reps << "), checksum "
+              << checksum << ", relative error " << std::abs(checksum - expected) / std::max(1.0, std::abs(expected)) << "\n";
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "nbody.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// N-body time steps with O(n^2) direct summation (one bulk_schedule over the
+// particles) or a Barnes-Hut octree, built and traversed as recursive task trees.
+// Each step's time is reported, split into tree build and force phases for
+// Barnes-Hut, whose per-task cost follows the local particle density.
+
+// Recursive task tree over the octree. A node holding at most grain particles is
+// handed to small(node) whole; a bigger one gets pre(node), which may create its
+// children, then one task per child (the last inline), then post(node) once all
+// children are done, on whichever worker finished last. done() runs after that.
+template <class Small, class Pre, class Post>
+void visit_tree(std::execution::system_scheduler& scheduler, bh_node& node, std::size_t grain, const Small& small, const Pre& pre,
+                const Post& post, std::function<void()> done) {
+    if (node.count <= grain) {
+        small(node);
+        done();
+        return;
+    }
+    pre(node);
+    std::vector<bh_node*> children;
+    for (auto& c : node.child) {
+        if (c) children.push_back(c.get());
+    }
+    if (children.empty()) {
+        small(node);
+        done();
+        return;
+    }
+
+    auto pending = std::make_shared<std::atomic<std::size_t>>(children.size());
+    std::function<void()> join = [pending, &node, &post, done]() {
+        if (pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            post(node);
+            done();
+        }
+    };
+    for (std::size_t c = 0; c + 1 < children.size(); ++c) {
+        scheduler.schedule([&scheduler, child = children[c], grain, &small, &pre, &post, join]() {
+            visit_tree(scheduler, *child, grain, small, pre, post, join);
+        }, std::execution::priority_t::NORMAL);
+    }
+    visit_tree(scheduler, *children.back(), grain, small, pre, post, join);
+}
+
+// Runs visit_tree from the root on a worker and waits for it from the main thread.
+template <class Small, class Pre, class Post>
+void visit_tree_and_wait(std::execution::system_scheduler& scheduler, bh_node& root, std::size_t grain, const Small& small,
+                         const Pre& pre, const Post& post) {
+    std::atomic<bool> finished(false);
+    scheduler.schedule([&]() {
+        visit_tree(scheduler, root, grain, small, pre, post, [&finished]() { finished.store(true, std::memory_order_release); });
+    }, std::execution::priority_t::NORMAL);
+    while (!finished.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+struct bh_options {
+    double theta;
+    std::size_t leaf_size;
+    std::size_t grain;
+};
+
+bh_tree build_tree(std::execution::system_scheduler& scheduler, const particles& p, const bh_options& o) {
+    bh_tree tree(p);
+    visit_tree_and_wait(
+        scheduler, *tree.root, o.grain, [&](bh_node& node) { bh_build_serial(tree, p, node, o.leaf_size); },
+        [&](bh_node& node) { bh_split(tree, p, node, o.leaf_size); }, [&](bh_node& node) { bh_summarize(tree, p, node); });
+    return tree;
+}
+
+void tree_forces(std::execution::system_scheduler& scheduler, bh_tree& tree, particles& p, const bh_options& o) {
+    visit_tree_and_wait(
+        scheduler, *tree.root, o.grain, [&](bh_node& node) { bh_accel_node(tree, p, node, o.theta); }, [](bh_node&) {},
+        [](bh_node&) {});
+}
+
+void direct_forces(std::execution::system_scheduler& scheduler, particles& p) {
+    parallel_for(scheduler, p.size(), [&p](std::size_t i) { direct_accel(p, i); });
+}
+
+// Relative RMS difference between the tree and direct accelerations over a sample.
+double force_error(std::execution::system_scheduler& scheduler, particles& p, const bh_options& o) {
+    bh_tree tree = build_tree(scheduler, p, o);
+    tree_forces(scheduler, tree, p, o);
+    particles exact = p;
+    const std::size_t step = std::max<std::size_t>(1, p.size() / 256);
+    double diff = 0, norm = 0;
+    for (std::size_t i = 0; i < p.size(); i += step) {
+        direct_accel(exact, i);
+        diff += std::pow(p.ax[i] - exact.ax[i], 2) + std::pow(p.ay[i] - exact.ay[i], 2) + std::pow(p.az[i] - exact.az[i], 2);
+        norm += std::pow(exact.ax[i], 2) + std::pow(exact.ay[i], 2) + std::pow(exact.az[i], 2);
+    }
+    return std::sqrt(diff / norm);
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "20000"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    const long steps = std::max(1L, opts.get("steps", 5L));
+    const double dt = std::stod(opts.get("dt", std::string("0.001")));
+    const bh_options o{std::stod(opts.get("theta", std::string("0.5"))), static_cast<std::size_t>(std::max(1L, opts.get("leaf", 16L))),
+                       static_cast<std::size_t>(std::max(1L, opts.get("grain", 1024L)))};
+
+    if (mode != "direct" && mode != "barnes-hut" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected direct, barnes-hut or all)\n";
+        return 1;
+    }
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+    const particles initial = plummer_sphere(n, opts.get("seed", 1L));
+    std::cout << n << " particles (Plummer sphere), " << steps << " steps\n";
+
+    for (const char* name : {"direct", "barnes-hut"}) {
+        if (mode != "all" && mode != name) continue;
+        const bool tree = std::string(name) == "barnes-hut";
+
+        particles p = initial;
+        if (tree) std::cout << "barnes-hut force error vs direct: " << force_error(scheduler, p, o) << " (theta " << o.theta << ")\n";
+        p = initial;
+        double total = 0, build_total = 0;
+        for (long s = 0; s < steps; ++s) {
+            auto start = std::chrono::steady_clock::now();
+            double build = 0;
+            if (tree) {
+                bh_tree t = build_tree(scheduler, p, o);
+                build = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                tree_forces(scheduler, t, p, o);
+            } else {
+                direct_forces(scheduler, p);
+            }
+            parallel_for(scheduler, p.size(), [&p, dt](std::size_t i) { nbody_advance(p, i, dt); });
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << name << " step " << s << ": " << elapsed.count() * 1e3 << " ms";
+            if (tree) std::cout << " (build " << build * 1e3 << " ms)";
+            std::cout << "\n";
+            total += elapsed.count();
+            build_total += build;
+        }
+        std::cout << name << ": " << total / steps * 1e3 << " ms per step";
+        if (tree) std::cout << ", build " << build_total / steps * 1e3 << " ms";
+        std::cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include "system_scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+
+// Runs f(0) .. f(n - 1) through bulk_schedule and blocks until every call has
+// finished. The caller spins, so this must be called from outside the worker pool.
+template <class F>
+void parallel_for(std::execution::system_scheduler& scheduler, std::size_t n, F&& f) {
+    std::atomic<std::size_t> remaining(n);
+    scheduler.bulk_schedule(static_cast<uint32_t>(n), [&f, &remaining](uint32_t i) {
+        f(static_cast<std::size_t>(i));
+        remaining.fetch_sub(1, std::memory_order_release);
+    });
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+// Runs f(0) .. f(n - 1) with lazy binary splitting: one task starts with the whole
+// range and, before each run of grain indices, hands the upper half of what it
+// has left to a new task if its worker's queue is empty. Work is split only while
+// other workers are hungry enough to steal it, so irregular iterations balance
+// without fixing a fine chunk size up front. Blocks like parallel_for.
+template <class F>
+void lazy_parallel_for(std::execution::system_scheduler& scheduler, std::size_t n, std::size_t grain, F&& f) {
+    if (n == 0) return;
+    std::atomic<std::size_t> remaining(n);
+    std::function<void(std::size_t, std::size_t)> run = [&](std::size_t begin, std::size_t end) {
+        while (begin < end) {
+            if (end - begin > grain && scheduler.local_queue_empty()) {
+                const std::size_t mid = begin + (end - begin) / 2;
+                scheduler.schedule([&run, mid, end]() { run(mid, end); });
+                end = mid;
+            }
+            const std::size_t stop = std::min(end, begin + grain);
+            for (std::size_t i = begin; i < stop; ++i) f(i);
+            remaining.fetch_sub(stop - begin, std::memory_order_release);
+            begin = stop;
+        }
+    };
+    scheduler.schedule([&run, n]() { run(0, n); });
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+#endif // PARALLEL_FOR_HPP
@@ -0,0 +1,91 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "senders.hpp"
+#include "gemm_pipeline.hpp"
+#include "options.hpp"
+#include "element_types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// init -> transform -> GEMM -> checksum on n x n matrices, written once as a sender
+// pipeline (schedule, bulk, when_all, then, sync_wait) and once as a parallel_for
+// per stage with the main thread waiting in between ("fork-join").
+
+template <class T>
+accumulator_t<T> run_senders(std::execution::system_scheduler& scheduler, gemm_pipeline<T>& p) {
+    namespace ex = std::execution;
+    using Acc = accumulator_t<T>;
+    auto init = ex::when_all(ex::bulk(ex::schedule(scheduler), p.blocks, [&p](std::size_t b) { p.init_a(b); }),
+                             ex::bulk(ex::schedule(scheduler), p.blocks, [&p](std::size_t b) { p.init_b(b); }));
+    auto transform = ex::bulk(std::move(init), p.blocks, [&p](std::size_t b) { p.transform(b); });
+    auto multiply = ex::bulk(std::move(transform), p.blocks, [&p](std::size_t b) { p.multiply(b); });
+    auto checksum = ex::then(ex::bulk(std::move(multiply), p.blocks, [&p](std::size_t b) { p.checksum(b); }),
+                             [&p]() { return p.total(); });
+    Acc result{};
+    ex::sync_wait(ex::then(std::move(checksum), [&result](Acc sum) { result = sum; }));
+    return result;
+}
+
+template <class T>
+accumulator_t<T> run_fork_join(std::execution::system_scheduler& scheduler, gemm_pipeline<T>& p) {
+    parallel_for(scheduler, p.blocks, [&p](std::size_t b) {
+        p.init_a(b);
+        p.init_b(b);
+    });
+    parallel_for(scheduler, p.blocks, [&p](std::size_t b) { p.transform(b); });
+    parallel_for(scheduler, p.blocks, [&p](std::size_t b) { p.multiply(b); });
+    parallel_for(scheduler, p.blocks, [&p](std::size_t b) { p.checksum(b); });
+    return p.total();
+}
+
+template <class T>
+int run_benchmark(std::execution::system_scheduler& scheduler, const std::string& mode, std::size_t n, const options& opts) {
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "senders" && mode != "fork-join" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected senders, fork-join or all)\n";
+        return 1;
+    }
+
+    gemm_pipeline<T> p(n);
+    const double expected = static_cast<double>(gemm_pipeline<T>::expected_total(n));
+    for (const char* name : {"senders", "fork-join"}) {
+        if (mode != "all" && mode != name) continue;
+
+        double best = 0, checksum = 0;
+        for (long r = 0; r < reps; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            checksum = static_cast<double>(std::string(name) == "senders" ? run_senders(scheduler, p) : run_fork_join(scheduler, p));
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        std::cout << name << ": " << best << " ms (best of " << reps << "), checksum " << checksum << ", relative error "
+                  << std::abs(checksum - expected) / std::max(1.0, std::abs(expected)) << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "1024"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    std::string type = opts.get("type", std::string("double"));
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+
+    int status = 1;
+    bool known = dispatch_element_type(type, [&](auto tag) {
+        status = run_benchmark<typename decltype(tag)::type>(scheduler, mode, n, opts);
+    });
+    if (!known) {
+        std::cerr << "Unknown element type: " << type << " (expected int32, int16, int8, float or double)\n";
+        return 1;
+    }
+
+    return status;
+}
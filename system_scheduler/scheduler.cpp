@@ -1,12 +1,40 @@
 #include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "matrix.hpp"
+#include "gemm_packed.hpp"
+#include "gemm_recursive.hpp"
+#include "gemm_strassen.hpp"
+#include "options.hpp"
+#include "element_types.hpp"
+#include "matrix_file.hpp"
+#include "gemm_streaming.hpp"
+#include "first_touch.hpp"
+#include "block_grid.hpp"
+#include "runtime_stats.hpp"
+#include "cache_flush.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <cmath>
 #include <atomic>
+#include <exception>
+#include <utility>
 
-using Matrix = std::vector<std::vector<int>>;
+template <class T>
+using Matrix = std::vector<std::vector<T>>;
 
-void print_matrix(const Matrix &M, const std::string &name, int max_rows = 5, int max_cols = 5) {
+// Set when sweeping several sizes or repetitions, where only the result records are printed.
+bool quiet = false;
+
+template <class T>
+void print_matrix(const Matrix<T> &M, const std::string &name, int max_rows = 5, int max_cols = 5) {
+    if (quiet) return;
     std::cout << "Matrix " << name << " (top-left " << max_rows << "x" << max_cols << " portion):\n";
     for (int i = 0; i < std::min(max_rows, static_cast<int>(M.size())); ++i) {
         for (int j = 0; j < std::min(max_cols, static_cast<int>(M[i].size())); ++j) {
@@ -16,12 +44,67 @@ void print_matrix(const Matrix &M, const std::string &name, int max_rows = 5, in
     }
 }
 
-void multiply_matrices(const Matrix &A, const Matrix &B, Matrix &C, std::execution::system_scheduler& scheduler, std::atomic<int>& tasks_remaining) {
+template <class T>
+void print_matrix(matrix_view<T> M, const std::string &name, int max_rows = 5, int max_cols = 5) {
+    if (quiet) return;
+    std::cout << "Matrix " << name << " (top-left " << max_rows << "x" << max_cols << " portion):\n";
+    for (std::size_t i = 0; i < std::min<std::size_t>(max_rows, M.rows); ++i) {
+        for (std::size_t j = 0; j < std::min<std::size_t>(max_cols, M.cols); ++j) {
+            std::cout << M(i, j) << "\t";
+        }
+        std::cout << "\n";
+    }
+}
+
+// Benchmark data is first written in parallel, in the row blocks the kernels later
+// compute on, so its pages are spread over the workers' NUMA nodes rather than all
+// on the main thread's; first_touch.hpp explains why this is only best effort.
+// --init=serial has the main thread write everything, as the original benchmark did.
+bool serial_init = false;
+
+auto init_loop(std::execution::system_scheduler& scheduler) {
+    return [&scheduler](std::size_t n, auto&& f) {
+        if (serial_init) {
+            for (std::size_t i = 0; i < n; ++i) f(i);
+        } else {
+            parallel_for(scheduler, n, f);
+        }
+    };
+}
+
+template <class T>
+dense_matrix<T> make_matrix(std::size_t rows, std::size_t cols, T value, std::execution::system_scheduler& scheduler) {
+    dense_matrix<T> M(rows, cols, uninitialized);
+    first_touch_fill(M.view(), value, init_loop(scheduler));
+    return M;
+}
+
+// Rows are allocated and filled in multiply_matrices' row blocks.
+template <class T>
+Matrix<T> make_row_matrix(int rows, int cols, T value, std::execution::system_scheduler& scheduler) {
+    Matrix<T> M(rows);
+    int num_threads = std::thread::hardware_concurrency();
+    int block_size = rows / num_threads;
+    init_loop(scheduler)(num_threads, [&](int t) {
+        int start_row = t * block_size;
+        int end_row = (t == num_threads - 1) ? rows : (t + 1) * block_size;
+        for (int i = start_row; i < end_row; ++i) {
+            M[i].assign(cols, value);
+        }
+    });
+    return M;
+}
+
+template <class T>
+void multiply_matrices(const Matrix<T> &A, const Matrix<T> &B, Matrix<result_t<T>> &C, std::execution::system_scheduler& scheduler, std::atomic<int>& tasks_remaining) {
+    using Acc = accumulator_t<T>;
+    using R = result_t<T>;
+
     int rowsA = A.size();
     int colsA = A[0].size();
     int colsB = B[0].size();
 
-    C.resize(rowsA, std::vector<int>(colsB, 0));
+    C.resize(rowsA, std::vector<R>(colsB, 0));
 
     int num_threads = std::thread::hardware_concurrency();
     int block_size = rowsA / num_threads;
@@ -35,11 +118,11 @@ void multiply_matrices(const Matrix &A, const Matrix &B, Matrix &C, std::executi
         scheduler.schedule([start_row, end_row, colsA, colsB, &A, &B, &C, &tasks_remaining]() {
             for (int i = start_row; i < end_row; ++i) {
                 for (int j = 0; j < colsB; ++j) {
-                    double sum = 0.0;
+                    Acc sum = 0;
                     for (int k = 0; k < colsA; ++k) {
-                        sum += static_cast<double>(A[i][k]) * B[k][j] * std::sin(A[i][k]);
+                        sum += weighted(A[i][k]) * static_cast<Acc>(B[k][j]);
                     }
-                    C[i][j] = static_cast<int>(sum);
+                    C[i][j] = static_cast<R>(sum);
                 }
             }
             tasks_remaining.fetch_sub(1, std::memory_order_relaxed);
@@ -47,29 +130,481 @@ void multiply_matrices(const Matrix &A, const Matrix &B, Matrix &C, std::executi
     }
 }
 
-int main(int argc, char* argv[]) {
-    int size = 500;
-    if (argc >= 2) {
-        size = std::stoi(argv[1]);
-        if (size <= 0) return 1;
+// C[r0, r1) x [c0, c1) computed exactly as multiply_matrices does, so the chunked
+// kernel differs from it only in how the work is decomposed.
+template <class T>
+void multiply_block(const Matrix<T> &A, const Matrix<T> &B, Matrix<result_t<T>> &C, const block_grid::block& blk) {
+    using Acc = accumulator_t<T>;
+    using R = result_t<T>;
+    const std::size_t inner = B.size();
+    for (std::size_t i = blk.r0; i < blk.r1; ++i) {
+        for (std::size_t j = blk.c0; j < blk.c1; ++j) {
+            Acc sum = 0;
+            for (std::size_t k = 0; k < inner; ++k) {
+                sum += weighted(A[i][k]) * static_cast<Acc>(B[k][j]);
+            }
+            C[i][j] = static_cast<R>(sum);
+        }
     }
-    Matrix A(size, std::vector<int>(size, 1));
-    Matrix B(size, std::vector<int>(size, 1));
-    Matrix C;
-    std::atomic<int> tasks_remaining(0);
+}
 
-    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
-    multiply_matrices(A, B, C, scheduler, tasks_remaining);
+// Parallelises over rows or tiles of C directly instead of one block per thread;
+// each task runs `chunk` consecutive items.
+template <class T>
+void multiply_matrices_chunked(const Matrix<T> &A, const Matrix<T> &B, Matrix<result_t<T>> &C, const block_grid& grid, std::size_t chunk, std::execution::system_scheduler& scheduler) {
+    parallel_for(scheduler, (grid.size() + chunk - 1) / chunk, [&](std::size_t t) {
+        const std::size_t last = std::min(grid.size(), (t + 1) * chunk);
+        for (std::size_t b = t * chunk; b < last; ++b) {
+            multiply_block(A, B, C, grid[b]);
+        }
+    });
+}
+
+// Converts acc into C, reusing C's storage when it already has acc's shape.
+template <class Acc, class R>
+void store_result(matrix_view<Acc> acc, dense_matrix<R> &C, std::execution::system_scheduler& scheduler) {
+    if (C.rows() != acc.rows || C.cols() != acc.cols) C = dense_matrix<R>(acc.rows, acc.cols, uninitialized);
+    parallel_for(scheduler, C.rows(), [&](std::size_t i) {
+        for (std::size_t j = 0; j < C.cols(); ++j) {
+            C(i, j) = static_cast<R>(acc(i, j));
+        }
+    });
+}
 
-    while (tasks_remaining.load(std::memory_order_relaxed) > 0) {
+// Same product computed on contiguous storage with packed, unit-stride panels of A
+// and B, accumulated into acc, which must be zero.
+template <class T>
+void multiply_matrices_packed(matrix_view<const T> A, matrix_view<const T> B, matrix_view<accumulator_t<T>> acc, dense_matrix<result_t<T>> &C, std::execution::system_scheduler& scheduler) {
+    gemm_packed(A, B, acc, weighted<T>, [&scheduler](std::size_t n, auto&& f) {
+        parallel_for(scheduler, n, f);
+    });
+    store_result(acc, C, scheduler);
+}
+
+// C += op(A) * B as a fork-join task tree. For m- and n-splits one half is spawned
+// and the other runs inline; k-halves write the same C, so the second is chained
+// behind the first. done() runs once, on whichever worker finishes the last leaf.
+template <class TA, class TB, class Acc, class Op>
+void recursive_gemm(std::execution::system_scheduler& scheduler, matrix_view<TA> A, matrix_view<TB> B, matrix_view<Acc> C, Op op, std::function<void()> done) {
+    split_dim dim = choose_split(A.rows, B.cols, A.cols);
+    if (dim == split_dim::none) {
+        gemm_base(A, B, C, op);
+        done();
+        return;
+    }
+
+    auto h = split_gemm(dim, A, B, C);
+    if (dim == split_dim::k) {
+        recursive_gemm(scheduler, h.a[0], h.b[0], h.c[0], op, [&scheduler, h, op, done]() {
+            recursive_gemm(scheduler, h.a[1], h.b[1], h.c[1], op, done);
+        });
+        return;
+    }
+
+    auto pending = std::make_shared<std::atomic<int>>(2);
+    std::function<void()> join = [pending, done]() {
+        if (pending->fetch_sub(1, std::memory_order_acq_rel) == 1) done();
+    };
+    scheduler.schedule([&scheduler, h, op, join]() {
+        recursive_gemm(scheduler, h.a[0], h.b[0], h.c[0], op, join);
+    }, std::execution::priority_t::NORMAL);
+    recursive_gemm(scheduler, h.a[1], h.b[1], h.c[1], op, join);
+}
+
+// Cache-oblivious divide and conquer: no block size to tune beyond the base case.
+// Accumulates into acc, which must be zero.
+template <class T>
+void multiply_matrices_recursive(matrix_view<const T> A, matrix_view<const T> B, matrix_view<accumulator_t<T>> acc, dense_matrix<result_t<T>> &C, std::execution::system_scheduler& scheduler) {
+    std::atomic<bool> finished(false);
+
+    scheduler.schedule([&]() {
+        recursive_gemm(scheduler, A, B, acc, weighted<T>, [&finished]() {
+            finished.store(true, std::memory_order_release);
+        });
+    }, std::execution::priority_t::NORMAL);
+
+    while (!finished.load(std::memory_order_acquire)) {
         std::this_thread::yield();
     }
+    store_result(acc, C, scheduler);
+}
 
-    print_matrix(C, "C", 5, 5);
+// Winograd's variant of Strassen on a square block whose size halves evenly down
+// to the cutoff. Near the root six of the seven products are spawned as tasks and
+// one runs inline; deeper levels run inline so temporaries stay bounded. The last
+// product to finish combines them into C and calls done().
+template <class Acc>
+void strassen_gemm(std::execution::system_scheduler& scheduler, buffer_pool<Acc>& pool, matrix_view<const Acc> A, matrix_view<const Acc> B, matrix_view<Acc> C, std::size_t cutoff, std::size_t depth, std::function<void()> done) {
+    if (A.rows <= cutoff) {
+        for (std::size_t i = 0; i < C.rows; ++i) {
+            std::fill_n(C.row(i), C.cols, Acc{});
+        }
+        gemm_packed(A, B, C, [](Acc a) { return a; }, [](std::size_t n, auto&& f) {
+            for (std::size_t i = 0; i < n; ++i) f(i);
+        });
+        done();
+        return;
+    }
+
+    auto ws = std::make_shared<strassen_workspace<Acc>>(pool, A.rows / 2);
+    auto products = winograd_operands(A, B, *ws);
+    auto pending = std::make_shared<std::atomic<int>>(static_cast<int>(products.size()));
+    std::function<void()> join = [ws, C, pending, done]() {
+        if (pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            winograd_combine(*ws, C);
+            ws->release();
+            done();
+        }
+    };
+
+    for (std::size_t i = 0; i < products.size(); ++i) {
+        auto run = [&scheduler, &pool, p = products[i], out = ws->p(i), cutoff, depth, join]() {
+            strassen_gemm<Acc>(scheduler, pool, p.a, p.b, out, cutoff, depth + 1, join);
+        };
+        if (depth < strassen_parallel_depth && i + 1 < products.size()) {
+            scheduler.schedule(run, std::execution::priority_t::NORMAL);
+        } else {
+            run();
+        }
+    }
+}
+
+// Operands padded to a size that halves evenly down to the cutoff, and the padded
+// product. Allocated once per size; the padding stays zero across runs.
+template <class Acc>
+struct strassen_operands {
+    strassen_operands(std::size_t n, std::size_t cutoff, std::execution::system_scheduler& scheduler)
+        : n(n), padded(strassen_padded_size(n, cutoff)), a(make_matrix<Acc>(padded, padded, 0, scheduler)),
+          b(make_matrix<Acc>(padded, padded, 0, scheduler)), c(make_matrix<Acc>(padded, padded, 0, scheduler)) {}
+
+    std::size_t n, padded;
+    dense_matrix<Acc> a, b, c;
+};
+
+// Copies A and B into the padded operands and runs strassen_gemm.
+template <class T>
+void multiply_matrices_strassen(matrix_view<const T> A, matrix_view<const T> B, strassen_operands<accumulator_t<T>>& w, dense_matrix<result_t<T>> &C, std::execution::system_scheduler& scheduler, std::size_t cutoff) {
+    using Acc = accumulator_t<T>;
+    parallel_for(scheduler, w.n, [&](std::size_t i) {
+        for (std::size_t j = 0; j < w.n; ++j) {
+            w.a(i, j) = weighted(A(i, j));
+            w.b(i, j) = static_cast<Acc>(B(i, j));
+        }
+    });
+
+    buffer_pool<Acc> pool;
+    std::atomic<bool> finished(false);
+    scheduler.schedule([&]() {
+        strassen_gemm<Acc>(scheduler, pool, std::as_const(w.a).view(), std::as_const(w.b).view(), w.c.view(), cutoff, 0, [&finished]() {
+            finished.store(true, std::memory_order_release);
+        });
+    }, std::execution::priority_t::NORMAL);
+
+    while (!finished.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    store_result(std::as_const(w.c).view().block(0, 0, w.n, w.n), C, scheduler);
+}
+
+// Compares the last strassen result against the classic packed kernel and returns
+// false if the difference exceeds the Winograd error bound.
+template <class T>
+bool check_strassen(matrix_view<const T> A, matrix_view<const T> B, const strassen_operands<accumulator_t<T>>& w, std::execution::system_scheduler& scheduler, std::size_t cutoff) {
+    using Acc = accumulator_t<T>;
+    dense_matrix<Acc> classic(w.n, w.n);
+    gemm_packed(A, B, classic.view(), weighted<T>, [&scheduler](std::size_t count, auto&& f) {
+        parallel_for(scheduler, count, f);
+    });
+    Acc error = max_abs_diff<Acc>(w.c.view().block(0, 0, w.n, w.n), classic.view());
+    Acc bound = strassen_error_bound(w.padded, strassen_leaf_size(w.padded, cutoff), max_abs<Acc>(w.a.view()), max_abs<Acc>(w.b.view()));
+    bool within_bound = error <= bound;
+    std::cout << "Strassen check: max |C - C_classic| = " << error << ", bound = " << bound
+              << (within_bound ? " (ok)" : " (EXCEEDED)") << "\n";
+    return within_bound;
+}
+
+// Completion flag for work run in the background on the scheduler. wait() spins
+// until it has finished and rethrows anything it threw.
+struct background_task {
+    std::atomic<bool> done{true};
+    std::exception_ptr error;
+
+    template <class F>
+    void start(std::execution::system_scheduler& scheduler, F f) {
+        done.store(false, std::memory_order_relaxed);
+        scheduler.schedule([this, f]() {
+            try {
+                f();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            done.store(true, std::memory_order_release);
+        }, std::execution::priority_t::NORMAL);
+    }
+
+    void finish() {
+        while (!done.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void wait() {
+        finish();
+        if (error) std::rethrow_exception(std::exchange(error, nullptr));
+    }
+};
+
+// Out-of-core product over matrix files within a memory budget. While the packed
+// kernel multiplies one pair of tiles on the workers, a background task reads the
+// next pair into the other buffer; finished C tiles are converted and written by
+// another, so the caller only waits when I/O is slower than compute.
+template <class T>
+void multiply_matrices_streaming(const matrix_tile_file<T> &A, const matrix_tile_file<T> &B, const matrix_tile_file<result_t<T>> &C, std::size_t budget_bytes, std::execution::system_scheduler& scheduler) {
+    using Acc = accumulator_t<T>;
+    const std::size_t tile = streaming_tile_size<T, Acc>(budget_bytes);
+    const auto steps = streaming_steps(A.rows(), B.cols(), A.cols(), tile);
+    streaming_buffers<T, Acc> buffers(tile);
+    background_task reads[2];
+    background_task writes[2];
+
+    auto read_step = [&](std::size_t s) {
+        const int slot = s % 2;
+        reads[slot].start(scheduler, [&A, &B, &buffers, st = steps[s], slot]() {
+            A.read(st.i0, st.k0, buffers.a_tile(slot, st));
+            B.read(st.k0, st.j0, buffers.b_tile(slot, st));
+        });
+    };
+
+    try {
+        if (!steps.empty()) read_step(0);
+        int c_slot = 0;
+        for (std::size_t s = 0; s < steps.size(); ++s) {
+            const streaming_step& st = steps[s];
+            reads[s % 2].wait();
+            if (s + 1 < steps.size()) read_step(s + 1);
+
+            matrix_view<Acc> acc = buffers.c_tile(c_slot, st);
+            if (st.first_k) {
+                writes[c_slot].wait();
+                for (std::size_t i = 0; i < acc.rows; ++i) {
+                    std::fill_n(acc.row(i), acc.cols, Acc{});
+                }
+            }
+            gemm_packed(buffers.a_tile(s % 2, st), buffers.b_tile(s % 2, st), acc, weighted<T>, [&scheduler](std::size_t n, auto&& f) {
+                parallel_for(scheduler, n, f);
+            });
+            if (st.last_k) {
+                writes[c_slot].start(scheduler, [&C, st, acc]() {
+                    write_back_tile<Acc>(C, st.i0, st.j0, acc);
+                });
+                c_slot = 1 - c_slot;
+            }
+        }
+        for (auto& w : writes) w.wait();
+    } catch (...) {
+        for (auto& r : reads) r.finish();
+        for (auto& w : writes) w.finish();
+        throw;
+    }
+}
+
+// Builds the operands for one size, then has time_reps run the kernel once per
+// repetition: time_reps(prepare, kernel) calls prepare untimed before each timed
+// kernel call. The result is printed and saved once, after the last repetition.
+template <class T, class TimeReps>
+int run_benchmark(std::execution::system_scheduler& scheduler, const std::string& kernel, int size, const options& opts, TimeReps&& time_reps) {
+    using R = result_t<T>;
+    using Acc = accumulator_t<T>;
+    auto nothing = []() {};
+
+    if (kernel == "naive") {
+        if (opts.has("a") || opts.has("b")) {
+            std::cerr << "File operands need a contiguous kernel (packed, recursive or strassen)\n";
+            return 1;
+        }
+        Matrix<T> A = make_row_matrix<T>(size, size, 1, scheduler);
+        Matrix<T> B = make_row_matrix<T>(size, size, 1, scheduler);
+        Matrix<R> C = make_row_matrix<R>(size, size, 0, scheduler);
+        std::atomic<int> tasks_remaining(0);
+
+        time_reps(nothing, [&]() {
+            multiply_matrices(A, B, C, scheduler, tasks_remaining);
+            while (tasks_remaining.load(std::memory_order_relaxed) > 0) {
+                std::this_thread::yield();
+            }
+        });
+
+        print_matrix(C, "C", 5, 5);
+    } else if (kernel == "chunked") {
+        std::string grain = opts.get("grain", std::string("rows"));
+        std::size_t tile = std::max(1L, opts.get("tile", 64L));
+        if (grain != "rows" && grain != "tiles") {
+            std::cerr << "Unknown grain: " << grain << " (expected rows or tiles)\n";
+            return 1;
+        }
+        block_grid grid{static_cast<std::size_t>(size), static_cast<std::size_t>(size),
+                        grain == "rows" ? 1 : tile, grain == "rows" ? static_cast<std::size_t>(size) : tile};
+        Matrix<T> A = make_row_matrix<T>(size, size, 1, scheduler);
+        Matrix<T> B = make_row_matrix<T>(size, size, 1, scheduler);
+        Matrix<R> C = make_row_matrix<R>(size, size, 0, scheduler);
+
+        std::size_t chunk = std::max(1L, opts.get("chunk-size", 1L));
+        time_reps(nothing, [&]() { multiply_matrices_chunked(A, B, C, grid, chunk, scheduler); });
+        print_matrix(C, "C", 5, 5);
+    } else if (kernel == "packed" || kernel == "recursive" || kernel == "strassen") {
+        auto generate = [&]() { return make_matrix<T>(size, size, 1, scheduler); };
+        input_matrix<T> A(opts.get("a", std::string()), generate);
+        input_matrix<T> B(opts.get("b", std::string()), generate);
+        dense_matrix<R> C;
+
+        if (A.view().cols != B.view().rows) {
+            std::cerr << "Inner dimensions differ: A is " << A.view().rows << "x" << A.view().cols
+                      << ", B is " << B.view().rows << "x" << B.view().cols << "\n";
+            return 1;
+        }
+
+        if (kernel == "packed" || kernel == "recursive") {
+            auto acc = make_matrix<Acc>(A.view().rows, B.view().cols, 0, scheduler);
+            C = make_matrix<R>(A.view().rows, B.view().cols, 0, scheduler);
+            auto zero_acc = [&]() {
+                init_loop(scheduler)(acc.rows(), [&](std::size_t i) { std::fill_n(acc.view().row(i), acc.cols(), Acc{}); });
+            };
+            time_reps(zero_acc, [&]() {
+                if (kernel == "packed") {
+                    multiply_matrices_packed(A.view(), B.view(), acc.view(), C, scheduler);
+                } else {
+                    multiply_matrices_recursive(A.view(), B.view(), acc.view(), C, scheduler);
+                }
+            });
+        } else {
+            if (A.view().rows != A.view().cols || B.view().rows != B.view().cols) {
+                std::cerr << "The strassen kernel needs square operands\n";
+                return 1;
+            }
+            std::size_t cutoff = std::max(1L, opts.get("cutoff", static_cast<long>(strassen_default_cutoff)));
+            strassen_operands<Acc> w(A.view().rows, cutoff, scheduler);
+            C = make_matrix<R>(A.view().rows, B.view().cols, 0, scheduler);
+            time_reps(nothing, [&]() { multiply_matrices_strassen(A.view(), B.view(), w, C, scheduler, cutoff); });
+            if (opts.has("check") && !check_strassen(A.view(), B.view(), w, scheduler, cutoff)) return 1;
+        }
+        print_matrix(C.view(), "C", 5, 5);
+
+        std::string prefix = opts.get("save", std::string());
+        if (!prefix.empty()) {
+            write_matrix_file(prefix + ".a.mat", A.view());
+            write_matrix_file(prefix + ".b.mat", B.view());
+            write_matrix_file<R>(prefix + ".c.mat", C.view());
+        }
+    } else if (kernel == "streaming") {
+        std::string prefix = opts.get("save", std::string("streaming"));
+        std::string a_path = opts.get("a", std::string());
+        std::string b_path = opts.get("b", std::string());
+        if (a_path.empty()) fill_matrix_file<T>(a_path = prefix + ".a.mat", size, size, 1);
+        if (b_path.empty()) fill_matrix_file<T>(b_path = prefix + ".b.mat", size, size, 1);
+
+        matrix_tile_file<T> A(a_path);
+        matrix_tile_file<T> B(b_path);
+        if (A.cols() != B.rows()) {
+            std::cerr << "Inner dimensions differ: A is " << A.rows() << "x" << A.cols()
+                      << ", B is " << B.rows() << "x" << B.cols() << "\n";
+            return 1;
+        }
+        create_matrix_file<R>(prefix + ".c.mat", A.rows(), B.cols());
+        matrix_tile_file<R> C(prefix + ".c.mat", true);
+
+        std::size_t budget = static_cast<std::size_t>(std::max(1L, opts.get("memory", static_cast<long>(streaming_default_budget_mib)))) << 20;
+        time_reps(nothing, [&]() { multiply_matrices_streaming(A, B, C, budget, scheduler); });
+
+        dense_matrix<R> corner(std::min<std::size_t>(5, C.rows()), std::min<std::size_t>(5, C.cols()));
+        C.read(0, 0, corner.view());
+        print_matrix(corner.view(), "C", 5, 5);
+    } else {
+        std::cerr << "Unknown kernel: " << kernel << " (expected naive, chunked, packed, recursive, strassen or streaming)\n";
+        return 1;
+    }
 
     return 0;
 }
 
+// The scheduler's own counters in the fields shared with the HPX program.
+runtime_stats collect_stats(const std::execution::system_scheduler& scheduler) {
+    auto stats = scheduler.get_stats();
+    const double worker_ns = stats.elapsed_ns * stats.threads;
+    return {{"threads", stats.threads},
+            {"tasks", static_cast<double>(stats.tasks)},
+            {"steals", static_cast<double>(stats.steals)},
+            {"elapsed_s", stats.elapsed_ns * 1e-9},
+            {"idle_rate", worker_ns > 0 ? stats.idle_ns / worker_ns : 0.0},
+            {"average_overhead_ns", stats.tasks > 0 ? stats.idle_ns / stats.tasks : 0.0}};
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    std::vector<long> sizes = options::parse_list(opts.positional(0, "500"));
+    if (sizes.empty() || *std::min_element(sizes.begin(), sizes.end()) <= 0) return 1;
+    const long reps = std::max(1L, opts.get("reps", 1L));
+    std::string kernel = opts.positional(1, "naive");
+    std::string type = opts.get("type", std::string("int32"));
+    std::string init = opts.get("init", std::string("parallel"));
+    if (init != "parallel" && init != "serial") {
+        std::cerr << "Unknown initialisation: " << init << " (expected parallel or serial)\n";
+        return 1;
+    }
+    serial_init = init == "serial";
+    quiet = sizes.size() > 1 || reps > 1;
 
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
 
+    std::optional<cache_flusher> flusher;
+    if (opts.has("flush")) {
+        std::string mib = opts.get("flush", std::string());
+        flusher.emplace((mib.empty() ? cache_flush_default_mib : std::stoul(mib)) << 20);
+    }
+
+    // Every size and repetition runs in this one scheduler instance, so the timings
+    // exclude process and runtime start-up. Operands are built once per size; each
+    // repetition flushes the caches if asked and resets the counters right before
+    // the kernel, so only the kernel is timed and counted. The stats printed are
+    // those of the fastest repetition.
+    for (long size : sizes) {
+        int status = 1;
+        bool known = true;
+        double best = 0, total = 0;
+        runtime_stats best_stats;
+        auto time_reps = [&](auto&& prepare, auto&& kernel) {
+            for (long r = 0; r < reps; ++r) {
+                prepare();
+                if (flusher) {
+                    flusher->flush([&scheduler](std::size_t n, auto&& f) { parallel_for(scheduler, n, f); });
+                }
+                scheduler.reset_stats();
+                auto start = std::chrono::steady_clock::now();
+                kernel();
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                if (r == 0 || elapsed.count() < best) {
+                    best = elapsed.count();
+                    best_stats = collect_stats(scheduler);
+                }
+                total += elapsed.count();
+            }
+        };
+        try {
+            known = dispatch_element_type(type, [&](auto tag) {
+                status = run_benchmark<typename decltype(tag)::type>(scheduler, kernel, static_cast<int>(size), opts, time_reps);
+            });
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        if (!known) {
+            std::cerr << "Unknown element type: " << type << " (expected int32, int16, int8, float or double)\n";
+            return 1;
+        }
+        if (status != 0) return status;
+        print_record(std::cout, "result", "system_scheduler",
+                     {{"size", static_cast<double>(size)}, {"reps", static_cast<double>(reps)}, {"best_s", best}, {"mean_s", total / reps}});
+        if (opts.has("stats")) print_runtime_stats(std::cout, "system_scheduler", best_stats);
+    }
 
+    return 0;
+}
@@ -0,0 +1,103 @@
+#ifndef SENDERS_HPP
+#define SENDERS_HPP
+
+#include "system_scheduler.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace std::execution {
+
+// Continuation-passing senders on system_scheduler: enough of P2300's vocabulary
+// (schedule, then, bulk, when_all, sync_wait) to write the same pipelines as with
+// HPX's implementation. A sender is started with a receiver, a callable taking the
+// sender's values; there are no error or stopped channels. Each sender carries the
+// scheduler it completes on, which bulk uses to run its iterations.
+template <class Start>
+struct scheduler_sender {
+    system_scheduler* scheduler;
+    Start start;
+};
+
+template <class Start>
+scheduler_sender<Start> make_sender(system_scheduler* scheduler, Start start) {
+    return {scheduler, std::move(start)};
+}
+
+inline auto schedule(system_scheduler& scheduler) {
+    return make_sender(&scheduler, [&scheduler](auto receiver) {
+        scheduler.schedule([receiver]() mutable { receiver(); });
+    });
+}
+
+// Completes with f(values...), or with no value if f returns void.
+template <class Start, class F>
+auto then(scheduler_sender<Start> sender, F f) {
+    return make_sender(sender.scheduler, [start = std::move(sender.start), f](auto receiver) mutable {
+        start([f, receiver](auto&&... values) mutable {
+            if constexpr (std::is_void_v<decltype(f(values...))>) {
+                f(values...);
+                receiver();
+            } else {
+                receiver(f(values...));
+            }
+        });
+    });
+}
+
+// Calls f(i, values...) for every i in [0, n) through bulk_schedule, then
+// completes with the predecessor's values on whichever worker finishes last.
+template <class Start, class F>
+auto bulk(scheduler_sender<Start> sender, std::size_t n, F f) {
+    system_scheduler* scheduler = sender.scheduler;
+    return make_sender(scheduler, [scheduler, start = std::move(sender.start), n, f](auto receiver) mutable {
+        start([scheduler, n, f, receiver](auto&&... values) mutable {
+            if (n == 0) {
+                receiver(values...);
+                return;
+            }
+            auto shared_values = std::make_shared<std::tuple<std::decay_t<decltype(values)>...>>(values...);
+            auto remaining = std::make_shared<std::atomic<std::size_t>>(n);
+            scheduler->bulk_schedule(static_cast<uint32_t>(n), [f, receiver, shared_values, remaining](uint32_t i) mutable {
+                std::apply([&](auto&... v) { f(static_cast<std::size_t>(i), v...); }, *shared_values);
+                if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) std::apply(receiver, *shared_values);
+            });
+        });
+    });
+}
+
+// Starts senders that complete without values concurrently and completes once
+// all of them have, on the scheduler of the first.
+template <class First, class... Rest>
+auto when_all(scheduler_sender<First> first, scheduler_sender<Rest>... rest) {
+    system_scheduler* scheduler = first.scheduler;
+    auto starts = std::make_tuple(std::move(first.start), std::move(rest.start)...);
+    return make_sender(scheduler, [starts = std::move(starts)](auto receiver) mutable {
+        auto remaining = std::make_shared<std::atomic<std::size_t>>(1 + sizeof...(Rest));
+        std::apply([&](auto&... start) {
+            (start([remaining, receiver]() mutable {
+                if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) receiver();
+            }), ...);
+        }, starts);
+    });
+}
+
+// Starts the sender and spins until it completes, discarding its values; end the
+// pipeline with then() to keep them. Call from outside the worker pool.
+template <class Start>
+void sync_wait(scheduler_sender<Start> sender) {
+    std::atomic<bool> done(false);
+    sender.start([&done](auto&&...) { done.store(true, std::memory_order_release); });
+    while (!done.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace std::execution
+
+#endif // SENDERS_HPP
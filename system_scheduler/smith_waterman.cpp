@@ -0,0 +1,107 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "smith_waterman.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Smith-Waterman alignment of two length-n DNA sequences, the second a mutated
+// copy of the first, tiled for every size in --tile. "diagonal" runs one
+// bulk_schedule per anti-diagonal of tiles with the main thread waiting in
+// between; "dataflow" gives every tile a counter of unfinished north and west
+// neighbours and schedules it when that reaches zero, so the wavefront never
+// waits for a whole diagonal. Scores are checked against a serial DP.
+
+void run_diagonal(std::execution::system_scheduler& scheduler, sw_tiles& s) {
+    for (std::size_t d = 0; d + 1 < s.tile_rows + s.tile_cols; ++d) {
+        const std::size_t first = d < s.tile_cols ? 0 : d - s.tile_cols + 1, last = std::min(d, s.tile_rows - 1);
+        parallel_for(scheduler, last - first + 1, [&](std::size_t k) { s.run((first + k) * s.tile_cols + d - first - k); });
+    }
+}
+
+void run_dataflow(std::execution::system_scheduler& scheduler, sw_tiles& s) {
+    // pending[t]: how many of t's north and west neighbours are still running.
+    std::vector<std::atomic<int>> pending(s.count());
+    for (std::size_t t = 0; t < s.count(); ++t) {
+        pending[t].store((t >= s.tile_cols) + (t % s.tile_cols > 0), std::memory_order_relaxed);
+    }
+    std::atomic<std::size_t> remaining(s.count());
+
+    std::function<void(std::size_t)> run = [&](std::size_t t) {
+        s.run(t);
+        auto release = [&](std::size_t u) {
+            if (pending[u].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                scheduler.schedule([&run, u]() { run(u); }, std::execution::priority_t::NORMAL);
+            }
+        };
+        if (t + s.tile_cols < s.count()) release(t + s.tile_cols);
+        if (t % s.tile_cols + 1 < s.tile_cols) release(t + 1);
+        remaining.fetch_sub(1, std::memory_order_release);
+    };
+
+    scheduler.schedule([&run]() { run(0); }, std::execution::priority_t::NORMAL);
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "8192"));
+    if (n <= 0) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::vector<long> tiles = options::parse_list(opts.get("tile", std::string("64,256,1024")));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "diagonal" && mode != "dataflow" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected diagonal, dataflow or all)\n";
+        return 1;
+    }
+    if (tiles.empty() || *std::min_element(tiles.begin(), tiles.end()) <= 0) {
+        std::cerr << "--tile must be a list of positive sizes\n";
+        return 1;
+    }
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+    const std::string a = random_dna(n, opts.get("seed", 1L));
+    const std::string b = mutate_dna(a, 0.1, opts.get("seed", 1L) + 1);
+
+    auto start = std::chrono::steady_clock::now();
+    const int expected = sw_serial(a, b);
+    const double serial = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double cells = static_cast<double>(n) * n;
+    std::cout << n << " x " << n << " cells, serial " << serial * 1e3 << " ms, score " << expected << "\n";
+
+    for (long tile : tiles) {
+        sw_tiles probe(a, b, tile);
+        std::cout << "tile " << tile << " (" << probe.tile_rows << "x" << probe.tile_cols << " tiles, mean parallelism "
+                  << static_cast<double>(probe.count()) / (probe.tile_rows + probe.tile_cols - 1) << ")\n";
+        for (const char* name : {"diagonal", "dataflow"}) {
+            if (mode != "all" && mode != name) continue;
+
+            double best = 0;
+            int score = 0;
+            for (long r = 0; r < reps; ++r) {
+                sw_tiles s(a, b, tile);
+                start = std::chrono::steady_clock::now();
+                if (std::string(name) == "diagonal") {
+                    run_diagonal(scheduler, s);
+                } else {
+                    run_dataflow(scheduler, s);
+                }
+                const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                best = r == 0 ? elapsed : std::min(best, elapsed);
+                score = s.score();
+            }
+            std::cout << "  " << name << ": " << best * 1e3 << " ms (best of " << reps << "), " << cells / best * 1e-9
+                      << " GCUPS, speedup " << serial / best << ", score " << score << (score == expected ? "" : " MISMATCH") << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "system_scheduler.hpp"
+#include "parallel_for.hpp"
+#include "stencil.hpp"
+#include "options.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 2D heat diffusion over --tile x --tile tiles for --steps timesteps, advancing
+// every tile --block steps per task (temporal blocking when above 1). "barrier"
+// runs one bulk_schedule per task step with the main thread waiting in between;
+// "dataflow" starts each tile's next task step as soon as the tile, the neighbours
+// it reads and the neighbours whose previous step read it have finished theirs.
+
+void run_barrier(std::execution::system_scheduler& scheduler, heat_grid& g, const std::vector<std::size_t>& plan) {
+    for (std::size_t b = 0; b < plan.size(); ++b) {
+        auto src = std::as_const(g.buffers[b % 2]).view();
+        auto dst = g.buffers[(b + 1) % 2].view();
+        parallel_for(scheduler, g.tiles.size(), [&](std::size_t t) { heat_advance(g, t, src, dst, plan[b]); });
+    }
+}
+
+void run_dataflow(std::execution::system_scheduler& scheduler, heat_grid& g, const std::vector<std::size_t>& plan) {
+    const std::size_t tiles = g.tiles.size(), steps = plan.size();
+    // near[k > 1][t]: g.neighbours(t, k), which only depends on whether k > 1.
+    std::vector<std::vector<std::size_t>> near[2];
+    for (std::size_t k = 0; k < 2; ++k) {
+        for (std::size_t t = 0; t < tiles; ++t) near[k].push_back(g.neighbours(t, k + 1));
+    }
+    // pending[t * steps + b]: how many tasks (t, b) still waits for: (t, b - 1) and
+    // the previous step of each tile in near[heat_reach(plan, b) > 1][t].
+    std::vector<std::atomic<std::size_t>> pending(tiles * steps);
+    for (std::size_t t = 0; t < tiles; ++t) {
+        for (std::size_t b = 1; b < steps; ++b) {
+            pending[t * steps + b].store(1 + near[heat_reach(plan, b) > 1][t].size(), std::memory_order_relaxed);
+        }
+    }
+    std::atomic<std::size_t> remaining(tiles * steps);
+
+    std::function<void(std::size_t, std::size_t)> run = [&](std::size_t t, std::size_t b) {
+        heat_advance(g, t, std::as_const(g.buffers[b % 2]).view(), g.buffers[(b + 1) % 2].view(), plan[b]);
+        if (b + 1 < steps) {
+            // The tasks waiting on (t, b) are t's own next step and the next steps of
+            // the tiles in the same reach set, which heat_reach makes symmetric.
+            auto release = [&](std::size_t u) {
+                if (pending[u * steps + b + 1].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    scheduler.schedule([&run, u, b]() { run(u, b + 1); }, std::execution::priority_t::NORMAL);
+                }
+            };
+            release(t);
+            for (std::size_t u : near[heat_reach(plan, b + 1) > 1][t]) release(u);
+        }
+        remaining.fetch_sub(1, std::memory_order_release);
+    };
+
+    scheduler.bulk_schedule(static_cast<uint32_t>(tiles), [&run](uint32_t t) { run(t, 0); });
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    options opts(argc, argv);
+    long n = std::stol(opts.positional(0, "2048"));
+    if (n < 3) return 1;
+    std::string mode = opts.positional(1, "all");
+    const std::size_t steps = std::max(1L, opts.get("steps", 100L));
+    const std::size_t tile = std::max(1L, opts.get("tile", 128L));
+    const std::size_t block = std::min<std::size_t>(tile, std::max(1L, opts.get("block", 1L)));
+    const long reps = std::max(1L, opts.get("reps", 3L));
+
+    if (mode != "barrier" && mode != "dataflow" && mode != "all") {
+        std::cerr << "Unknown mode: " << mode << " (expected barrier, dataflow or all)\n";
+        return 1;
+    }
+
+    std::execution::system_scheduler scheduler(std::execution::priority_t::NORMAL, std::thread::hardware_concurrency());
+
+    const auto plan = heat_plan(steps, block);
+    heat_grid g(n, tile);
+    std::optional<heat_grid> expected;
+    if (opts.has("check")) {
+        expected.emplace(n, n);
+        for (std::size_t b = 0; b < steps; ++b) {
+            heat_advance(*expected, 0, std::as_const(expected->buffers[b % 2]).view(), expected->buffers[(b + 1) % 2].view(), 1);
+        }
+    }
+
+    std::cout << n << "x" << n << " grid, " << g.tiles.size() << " tiles of " << tile << "x" << tile << ", " << steps
+              << " steps, " << block << " per task\n";
+    for (const char* name : {"barrier", "dataflow"}) {
+        if (mode != "all" && mode != name) continue;
+
+        double best = 0;
+        for (long r = 0; r < reps; ++r) {
+            g.reset();
+            auto start = std::chrono::steady_clock::now();
+            if (std::string(name) == "barrier") {
+                run_barrier(scheduler, g, plan);
+            } else {
+                run_dataflow(scheduler, g, plan);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        std::cout << name << ": " << best * 1e3 << " ms (best of " << reps << "), "
+                  << static_cast<double>(n) * n * steps / best * 1e-6 << " Mcells/s";
+        if (expected) {
+            std::cout << ", max |u - u_serial| "
+                      << heat_max_diff(std::as_const(g.buffers[plan.size() % 2]).view(), std::as_const(expected->buffers[steps % 2]).view());
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
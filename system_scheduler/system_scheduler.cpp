@@ -14,6 +14,8 @@
 #include <functional>
 #include <atomic>
 #include <algorithm>
+#include <memory>
+#include <mutex>
 
 #ifdef __linux__
 #include <numa.h>
@@ -25,12 +27,16 @@ namespace {
 #ifdef __linux__
     thread_local int local_numa_node = 0;
 #endif
+
+    int64_t steady_now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 }
 
 namespace std::execution {
 
 system_scheduler::system_scheduler(priority_t priority, uint32_t thread_count) 
-    : priority_level(priority), stop_flag(false), next_queue(0) {
+    : priority_level(priority), stop_flag(false), next_queue(0), stats_epoch(steady_now_ns()) {
     uint32_t init_threads = thread_count > 0 ? thread_count : std::thread::hardware_concurrency();
     min_threads = init_threads;
     max_threads = init_threads;
@@ -41,6 +47,7 @@ system_scheduler::system_scheduler(priority_t priority, uint32_t thread_count)
     worker_numa_nodes.resize(max_threads, 0);
     work_queues.resize(max_threads);
     num_queues.store(max_threads, std::memory_order_relaxed);
+    counters = std::make_unique<worker_counters[]>(max_threads);
     
 #ifdef __linux__
     int num_nodes = (numa_available() != -1) ? numa_max_node() + 1 : 1;
@@ -78,16 +85,33 @@ void system_scheduler::set_priority(priority_t priority) noexcept {
     priority_level = priority;
 }
 
+int system_scheduler::current_worker_index() noexcept {
+    return is_worker_thread ? static_cast<int>(local_worker_index) : -1;
+}
+
+bool system_scheduler::local_queue_empty() const noexcept {
+    if (!is_worker_thread || local_worker_index >= num_queues.load(std::memory_order_relaxed)) return true;
+    return work_queues[local_worker_index].empty();
+}
+
 void system_scheduler::schedule(std::function<void()> task, priority_t priority) const noexcept {
     if (stop_flag.load(std::memory_order_relaxed)) return;
     
     size_t num = num_queues.load(std::memory_order_relaxed);
+    
+    // A worker's own deque is single-producer: tasks spawned by a worker stay local
+    // (and are stolen from there); all other submissions go through an inbox.
+    if (is_worker_thread && local_worker_index < num) {
+        work_queues[local_worker_index].push_task(static_cast<int>(priority), std::move(task));
+        return;
+    }
+    
     size_t chosen = next_queue.fetch_add(1, std::memory_order_relaxed) % num;
     
     while (!work_queues[chosen].active.load(std::memory_order_relaxed)) {
         chosen = (chosen + 1) % num;
     }
-    work_queues[chosen].push_task(static_cast<int>(priority), std::move(task));
+    work_queues[chosen].submit_task(static_cast<int>(priority), std::move(task));
 }
 
 void system_scheduler::bulk_schedule(uint32_t n, std::function<void(uint32_t)> task, priority_t priority) const noexcept {
@@ -128,6 +152,7 @@ void system_scheduler::worker_loop(size_t thread_id) {
     }
     
     std::mt19937 rng(std::random_device{}());
+    worker_counters& counter = counters[thread_id];
     
     while (true) {
         std::function<void()> task;
@@ -142,14 +167,25 @@ void system_scheduler::worker_loop(size_t thread_id) {
             for (size_t steal_id : steal_indices) {
                 if (work_queues[steal_id].active.load(std::memory_order_relaxed) && work_queues[steal_id].steal_task(task)) {
                     found_task = true;
+                    counter.steals.fetch_add(1, std::memory_order_relaxed);
                     break;
                 }
             }
         }
         
         if (found_task) {
+            int64_t since = counter.idle_since.load(std::memory_order_relaxed);
+            if (since != 0) {
+                since = std::max(since, stats_epoch.load(std::memory_order_relaxed));
+                counter.idle_ns.fetch_add(steady_now_ns() - since, std::memory_order_relaxed);
+                counter.idle_since.store(0, std::memory_order_relaxed);
+            }
+            counter.tasks.fetch_add(1, std::memory_order_relaxed);
             task();
         } else {
+            if (counter.idle_since.load(std::memory_order_relaxed) == 0) {
+                counter.idle_since.store(steady_now_ns(), std::memory_order_relaxed);
+            }
             idle_count.fetch_add(1, std::memory_order_relaxed);
             
             std::this_thread::sleep_for(std::chrono::microseconds(10));
@@ -165,6 +201,34 @@ void system_scheduler::worker_loop(size_t thread_id) {
     }
 }
 
+scheduler_stats system_scheduler::get_stats() const noexcept {
+    const int64_t now = steady_now_ns();
+    const int64_t epoch = stats_epoch.load(std::memory_order_relaxed);
+    scheduler_stats stats;
+    stats.threads = static_cast<uint32_t>(worker_threads.size());
+    stats.elapsed_ns = static_cast<double>(now - epoch);
+    for (uint32_t i = 0; i < max_threads; ++i) {
+        const worker_counters& counter = counters[i];
+        stats.tasks += counter.tasks.load(std::memory_order_relaxed);
+        stats.steals += counter.steals.load(std::memory_order_relaxed);
+        stats.idle_ns += static_cast<double>(counter.idle_ns.load(std::memory_order_relaxed));
+        // Count the idle stretch a worker is in right now, from the epoch at the earliest.
+        const int64_t since = counter.idle_since.load(std::memory_order_relaxed);
+        if (since != 0) stats.idle_ns += static_cast<double>(now - std::max(since, epoch));
+    }
+    return stats;
+}
+
+// Racy against workers that are running tasks, so call it while the pool is quiet.
+void system_scheduler::reset_stats() noexcept {
+    stats_epoch.store(steady_now_ns(), std::memory_order_relaxed);
+    for (uint32_t i = 0; i < max_threads; ++i) {
+        counters[i].tasks.store(0, std::memory_order_relaxed);
+        counters[i].steals.store(0, std::memory_order_relaxed);
+        counters[i].idle_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
 std::shared_ptr<system_scheduler> system_scheduler::query_system_context() {
     static std::shared_ptr<system_scheduler> instance = std::make_shared<system_scheduler>();
     return instance;
@@ -223,7 +287,11 @@ system_scheduler& get_system_scheduler(priority_t priority) {
     if (current_scheduler) {
         return *current_scheduler;
     }
+#if defined(__APPLE__)
     static macos_system_scheduler scheduler(priority);
+#else
+    static system_scheduler scheduler(priority);
+#endif
     return scheduler;
 }
 
@@ -11,6 +11,8 @@
 #include <vector>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <mutex>
 
 #ifdef __linux__
 #include <sched.h>
@@ -19,72 +21,57 @@
 
 namespace std::execution {
 
+// Chase-Lev work-stealing deque. Slots hold pointers to heap-allocated tasks, so
+// a thief that loses its CAS has only read a pointer and never touches a task
+// the owner or another thief took. Buffers replaced by resize() stay alive until
+// the deque is destroyed, since a thief may still be reading the old one.
 class lock_free_deque {
 public:
-    lock_free_deque() : capacity(DEFAULT_CAPACITY), top(0), bottom(0) {
-        buffer = std::make_unique<std::vector<std::function<void()>>>();
-        buffer->resize(capacity);
+    lock_free_deque() : top(0), bottom(0) {
+        retired.push_back(std::make_unique<task_array>(DEFAULT_CAPACITY));
+        buffer.store(retired.back().get(), std::memory_order_relaxed);
     }
     
     lock_free_deque(const lock_free_deque&) = delete;
     lock_free_deque& operator=(const lock_free_deque&) = delete;
+    lock_free_deque(lock_free_deque&&) = delete;
+    lock_free_deque& operator=(lock_free_deque&&) = delete;
     
-    lock_free_deque(lock_free_deque&& other) noexcept 
-        : capacity(other.capacity.load(std::memory_order_relaxed)), 
-          top(other.top.load(std::memory_order_relaxed)), 
-          bottom(other.bottom.load(std::memory_order_relaxed)), 
-          buffer(std::move(other.buffer)) {
-        other.capacity.store(0, std::memory_order_relaxed);
-        other.top.store(0, std::memory_order_relaxed);
-        other.bottom.store(0, std::memory_order_relaxed);
-        other.buffer = nullptr;
-    }
-    
-    lock_free_deque& operator=(lock_free_deque&& other) noexcept {
-        if (this != &other) {
-            capacity.store(other.capacity.load(std::memory_order_relaxed), std::memory_order_relaxed);
-            top.store(other.top.load(std::memory_order_relaxed), std::memory_order_relaxed);
-            bottom.store(other.bottom.load(std::memory_order_relaxed), std::memory_order_relaxed);
-            buffer = std::move(other.buffer);
-            other.capacity.store(0, std::memory_order_relaxed);
-            other.top.store(0, std::memory_order_relaxed);
-            other.bottom.store(0, std::memory_order_relaxed);
-            other.buffer = nullptr;
+    ~lock_free_deque() {
+        task_array* a = buffer.load(std::memory_order_relaxed);
+        for (int i = top.load(std::memory_order_relaxed); i < bottom.load(std::memory_order_relaxed); ++i) {
+            delete a->get(i);
         }
-        return *this;
     }
     
     void push(std::function<void()> task) {
         int b = bottom.load(std::memory_order_relaxed);
         int t = top.load(std::memory_order_acquire);
-        int size = b - t;
-        int cap = capacity.load(std::memory_order_relaxed);
+        task_array* a = buffer.load(std::memory_order_relaxed);
         
-        if (size >= cap) {
-            resize();
-            b = bottom.load(std::memory_order_relaxed);
-            cap = capacity.load(std::memory_order_relaxed);
+        if (b - t >= a->capacity) {
+            a = resize(a, t, b);
         }
         
-        (*buffer)[b % cap] = std::move(task);
+        a->put(b, new std::function<void()>(std::move(task)));
         bottom.store(b + 1, std::memory_order_release);
     }
     
     bool pop(std::function<void()>& task) {
         int b = bottom.load(std::memory_order_relaxed) - 1;
+        task_array* a = buffer.load(std::memory_order_relaxed);
         bottom.store(b, std::memory_order_seq_cst);
         int t = top.load(std::memory_order_seq_cst);
-        int cap = capacity.load(std::memory_order_relaxed);
         
         if (t <= b) {
-            task = std::move((*buffer)[b % cap]);
+            std::function<void()>* taken = a->get(b);
             if (t == b) {
-                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst)) {
-                    task = nullptr;
-                    bottom.store(b + 1, std::memory_order_relaxed);
-                    return false;
-                }
+                // Last element: race thieves for it, and leave the deque empty (top == bottom) either way.
+                bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                if (!won) return false;
             }
+            take(taken, task);
             return true;
         } else {
             bottom.store(b + 1, std::memory_order_relaxed);
@@ -93,12 +80,13 @@ public:
     }
     
     bool steal(std::function<void()>& task) {
-        int t = top.load(std::memory_order_acquire);
-        int b = bottom.load(std::memory_order_acquire);
-        int cap = capacity.load(std::memory_order_relaxed);
+        int t = top.load(std::memory_order_seq_cst);
+        int b = bottom.load(std::memory_order_seq_cst);
         if (t < b) {
-            task = std::move((*buffer)[t % cap]);
+            task_array* a = buffer.load(std::memory_order_acquire);
+            std::function<void()>* candidate = a->get(t);
             if (top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst)) {
+                take(candidate, task);
                 return true;
             }
         }
@@ -119,26 +107,35 @@ public:
 
 private:
     static constexpr int DEFAULT_CAPACITY = 1024;
-    std::atomic<int> capacity;
-    std::unique_ptr<std::vector<std::function<void()>>> buffer;
-    std::atomic<int> top;
-    std::atomic<int> bottom;
     
-    void resize() {
-        int old_capacity = capacity.load(std::memory_order_acquire);
-        int new_capacity = old_capacity * 2;
+    struct task_array {
+        explicit task_array(int capacity) : capacity(capacity), slots(new std::atomic<std::function<void()>*>[capacity]) {}
         
-        auto new_buffer = std::make_unique<std::vector<std::function<void()>>>();
-        new_buffer->resize(new_capacity);
+        std::function<void()>* get(int i) const { return slots[i % capacity].load(std::memory_order_relaxed); }
+        void put(int i, std::function<void()>* task) { slots[i % capacity].store(task, std::memory_order_relaxed); }
         
-        int t = top.load(std::memory_order_acquire);
-        int b = bottom.load(std::memory_order_acquire);
+        const int capacity;
+        std::unique_ptr<std::atomic<std::function<void()>*>[]> slots;
+    };
+    
+    std::atomic<task_array*> buffer;
+    std::vector<std::unique_ptr<task_array>> retired; // every buffer ever used, touched only by the owner
+    std::atomic<int> top;
+    std::atomic<int> bottom;
+    
+    static void take(std::function<void()>* taken, std::function<void()>& task) {
+        task = std::move(*taken);
+        delete taken;
+    }
+    
+    task_array* resize(task_array* old, int t, int b) {
+        retired.push_back(std::make_unique<task_array>(old->capacity * 2));
+        task_array* grown = retired.back().get();
         for (int i = t; i < b; ++i) {
-            (*new_buffer)[i % new_capacity] = std::move((*buffer)[i % old_capacity]);
+            grown->put(i, old->get(i));
         }
-        
-        buffer = std::move(new_buffer);
-        capacity.store(new_capacity, std::memory_order_release);
+        buffer.store(grown, std::memory_order_release);
+        return grown;
     }
 };
 
@@ -151,45 +148,59 @@ enum class priority_t {
 
 // Updated work_queue_t to handle priorities with lock_free_deque
 struct work_queue_t {
-    std::vector<std::shared_ptr<lock_free_deque>> task_queues; // One deque per priority
+    std::vector<std::shared_ptr<lock_free_deque>> task_queues; // One deque per priority, pushed only by the owning worker
+    std::vector<std::deque<std::function<void()>>> inbox;      // Tasks submitted from any other thread
+    std::mutex inbox_mutex;
+    std::atomic<size_t> inbox_size{0};
     std::atomic<bool> active{true};
     
-    work_queue_t() : task_queues(static_cast<size_t>(priority_t::CRITICAL) + 1) {
+    work_queue_t() : task_queues(static_cast<size_t>(priority_t::CRITICAL) + 1), inbox(task_queues.size()) {
         for (auto& queue : task_queues) {
             queue = std::make_shared<lock_free_deque>();
         }
     }
     
     work_queue_t(work_queue_t&& other) noexcept 
-        : task_queues(std::move(other.task_queues)), active(other.active.load()) {}
+        : task_queues(std::move(other.task_queues)), inbox(std::move(other.inbox)),
+          inbox_size(other.inbox_size.load()), active(other.active.load()) {}
     
     work_queue_t& operator=(work_queue_t&& other) noexcept {
         if (this != &other) {
             task_queues = std::move(other.task_queues);
+            inbox = std::move(other.inbox);
+            inbox_size.store(other.inbox_size.load());
             active.store(other.active.load());
         }
         return *this;
     }
     
+    // Only the owning worker may call push_task; the deque is single-producer.
     void push_task(int prio, std::function<void()> task) {
         task_queues[prio]->push(std::move(task));
     }
     
+    void submit_task(int prio, std::function<void()> task) {
+        std::scoped_lock lock(inbox_mutex);
+        inbox[prio].push_back(std::move(task));
+        inbox_size.fetch_add(1, std::memory_order_release);
+    }
+    
     bool pop_task(std::function<void()>& task) {
         for (int p = static_cast<int>(priority_t::CRITICAL); p >= static_cast<int>(priority_t::LOW); --p) {
-            if (task_queues[p]->pop(task)) return true;
+            if (task_queues[p]->pop(task) || take_submitted(p, task)) return true;
         }
         return false;
     }
     
     bool steal_task(std::function<void()>& task) {
         for (int p = static_cast<int>(priority_t::CRITICAL); p >= static_cast<int>(priority_t::LOW); --p) {
-            if (task_queues[p]->steal(task)) return true;
+            if (task_queues[p]->steal(task) || take_submitted(p, task)) return true;
         }
         return false;
     }
     
     bool empty() const {
+        if (inbox_size.load(std::memory_order_acquire) > 0) return false;
         for (const auto& dq : task_queues) {
             if (!dq->empty()) return false;
         }
@@ -197,12 +208,32 @@ struct work_queue_t {
     }
     
     size_t size() const {
-        size_t total = 0;
+        size_t total = inbox_size.load(std::memory_order_acquire);
         for (const auto& dq : task_queues) {
             total += dq->size();
         }
         return total;
     }
+
+private:
+    bool take_submitted(int prio, std::function<void()>& task) {
+        if (inbox_size.load(std::memory_order_acquire) == 0) return false;
+        std::scoped_lock lock(inbox_mutex);
+        if (inbox[prio].empty()) return false;
+        task = std::move(inbox[prio].front());
+        inbox[prio].pop_front();
+        inbox_size.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Worker counters summed over all workers since construction or the last reset_stats().
+struct scheduler_stats {
+    uint32_t threads = 0;
+    uint64_t tasks = 0;    // tasks run
+    uint64_t steals = 0;   // tasks taken from another worker's queue or inbox
+    double elapsed_ns = 0; // wall time the counters cover
+    double idle_ns = 0;    // time workers spent finding no task, summed over workers
 };
 
 class system_scheduler {
@@ -234,6 +265,20 @@ public:
         return active_thread_count.load(std::memory_order_relaxed);
     }
     
+    uint32_t get_thread_count() const noexcept {
+        return max_threads;
+    }
+    
+    // Index of the calling thread among its scheduler's workers, or -1 on any other thread.
+    static int current_worker_index() noexcept;
+    
+    // Whether the calling worker has no queued tasks another worker could steal;
+    // true on threads outside the pool.
+    bool local_queue_empty() const noexcept;
+    
+    scheduler_stats get_stats() const noexcept;
+    void reset_stats() noexcept;
+    
 private:
     priority_t priority_level;
     mutable std::vector<work_queue_t> work_queues;
@@ -250,6 +295,16 @@ private:
     mutable std::atomic<size_t> next_queue; // For round-robin scheduling
     mutable std::atomic<size_t> num_queues; // Store number of queues atomically
     
+    // Written only by the owning worker; one cache line each so they do not false-share.
+    struct alignas(64) worker_counters {
+        std::atomic<uint64_t> tasks{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<int64_t> idle_ns{0};
+        std::atomic<int64_t> idle_since{0}; // steady clock ns when the worker ran out of work, 0 while busy
+    };
+    std::unique_ptr<worker_counters[]> counters;
+    std::atomic<int64_t> stats_epoch;
+    
     void worker_loop(size_t thread_id);
 };
 
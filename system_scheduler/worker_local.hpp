@@ -0,0 +1,60 @@
+#ifndef WORKER_LOCAL_HPP
+#define WORKER_LOCAL_HPP
+
+#include "system_scheduler.hpp"
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// One T per worker of a scheduler, each on its own cache lines, so tasks can
+// accumulate without atomics and merge afterwards with combine() or for_each().
+// local() picks the slot of the calling worker; threads outside the pool share
+// one extra slot, so use it from that scheduler's tasks plus at most one other
+// thread. Merge only once the tasks writing to the slots have finished.
+template <class T>
+class worker_local {
+public:
+    explicit worker_local(const std::execution::system_scheduler& scheduler, const T& init = T{})
+        : count(scheduler.get_thread_count() + 1), slots(std::make_unique<slot[]>(count)) {
+        reset(init);
+    }
+
+    T& local() noexcept {
+        const int worker = std::execution::system_scheduler::current_worker_index();
+        const std::size_t i = worker >= 0 && static_cast<std::size_t>(worker) + 1 < count ? static_cast<std::size_t>(worker) : count - 1;
+        return slots[i].value;
+    }
+
+    std::size_t size() const noexcept { return count; }
+
+    template <class F>
+    void for_each(F&& f) {
+        for (std::size_t i = 0; i < count; ++i) f(slots[i].value);
+    }
+
+    template <class F>
+    void for_each(F&& f) const {
+        for (std::size_t i = 0; i < count; ++i) f(slots[i].value);
+    }
+
+    // Folds every slot into init with op(accumulated, slot).
+    template <class U, class Op>
+    U combine(U init, Op op) const {
+        for (std::size_t i = 0; i < count; ++i) init = op(std::move(init), slots[i].value);
+        return init;
+    }
+
+    void reset(const T& value) {
+        for (std::size_t i = 0; i < count; ++i) slots[i].value = value;
+    }
+
+private:
+    struct alignas(64) slot {
+        T value;
+    };
+
+    std::size_t count;
+    std::unique_ptr<slot[]> slots;
+};
+
+#endif // WORKER_LOCAL_HPP